@@ -15,6 +15,7 @@
 #include <avr/sleep.h>
 #include <util/delay.h>
 #include <util/delay_basic.h>
+#include "include/telemetry.h"
 
 #define CALIB_OSCCAL 0x03 // Frequency Calibration for Individual Difference at VCC = 3.3V
 
@@ -26,14 +27,36 @@
  *       First Byte: Bit[7] Always High, Bit[6:5] Channel Number, Bit[4:0] Most Significant 5 Bits
  *       Second Byte: Bit[7] Always Low, Bit[6:0] Least Significant 7 Bits
  *       ADC is 10-bit resolution.
+ * Note2: If ADC_UART_STREAM is 1, conversions are paced by Timer0 and transmitted continuously.
+ *        Bit[4:3] of the first byte, which is always zero in 10-bit resolution, carries a 4-bit sequence number.
+ *        Channel 1 has Bit[3:2] of the sequence number, and channel 2 has Bit[1:0] of the sequence number.
+ *        The sequence number increments per frame (4 bytes), so the host can detect dropped frames.
+ *        Four bytes at 38400 baud take 10000 clocks (960 frames per second at most),
+ *        and the frame rate is 9.6MHz / ( 64 * (ADC_UART_STREAM_TOP + 1) ) = 937.5Hz to leave time for the loop.
+ *        The conversion of channel 1 is started by Timer0 Compare Match A without software jitter,
+ *        and channel 2 of the previous frame is transmitted during the conversion.
+ * Note3: If ADC_UART_TELEMETRY is 1, samples are sent as frames of TELEMETRY_TYPE_ADC with CRC-8 (see include/telemetry.h).
+ *        Payload: Sequence Number, Channel 1 (Low, High), Channel 2 (Low, High), 10-bit Values in Little Endian
+ *        A frame (9 bytes) at 38400 baud takes 22500 clocks. In stream, the frame rate is 9.6MHz / ( 256 * (ADC_UART_STREAM_TOP + 1) ) = Approx. 407.6Hz.
+ *        Channel 1 is converted during the sync byte, and channel 2 is converted during the type and length bytes.
+ *        Use host/telemetry_decode to validate frames.
  */
 
+#define ADC_UART_STREAM 0 // 0 = Two Samples per Second, 1 = Stream Paced by Timer0
+#define ADC_UART_TELEMETRY 0 // 0 = 2-Byte Samples, 1 = Framed Telemetry with CRC-8
+#if ADC_UART_TELEMETRY
+#define ADC_UART_STREAM_TOP 91 // TOP of Timer0 in Stream, 23552 Clocks per Frame
+#define ADC_UART_STREAM_PRESCALER (_BV(CS02)) // 256
+#else
+#define ADC_UART_STREAM_TOP 159 // TOP of Timer0 in Stream, 10240 Clocks per Frame
+#define ADC_UART_STREAM_PRESCALER (_BV(CS01)|_BV(CS00)) // 64
+#endif
+#define ADC_UART_TELEMETRY_LENGTH 5 // Length of Payload
+
 /* Declare Function and Global Variables about Software UART */
 
-void software_uart_init( uint8_t portb_pin_number_for_tx );
-void software_uart_print_38400( char* string, uint16_t length, uint8_t portb_pin_number_for_tx );
-void software_uart_tx_38400( uint8_t character, uint8_t portb_pin_number_for_tx );
-uint8_t software_uart_tx_pin;
+#define SOFTWARE_UART_BAUD_RATE 38400
+#include "include_13/software_uart.h"
 
 /* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
 
@@ -51,6 +74,21 @@ int main(void) {
 	uint8_t value_adc_channel_1_high; // Bit[7:0] Is ADC[9:2]
 	uint8_t value_adc_channel_2_low; // Bit[7:6] Is ADC[1:0]
 	uint8_t value_adc_channel_2_high; // Bit[7:0] Is ADC[9:2]
+#if ADC_UART_TELEMETRY
+	uint8_t telemetry_payload[ADC_UART_TELEMETRY_LENGTH];
+	uint8_t telemetry_frame[ADC_UART_TELEMETRY_LENGTH + 4];
+	uint8_t telemetry_frame_length;
+	uint8_t telemetry_sequence = 0;
+#endif
+#if ADC_UART_STREAM
+	uint8_t const adc_complete = _BV(ADIF);
+#if ! ADC_UART_TELEMETRY
+	uint8_t stream_sequence = 0; // Bit[3:0] Sequence Number of Frame
+	uint8_t stream_is_second = 0; // Channel 2 of Previous Frame Is Outstanding
+	uint8_t stream_channel_2_first = 0;
+	uint8_t stream_channel_2_second = 0;
+#endif
+#endif
 
 	/* Initialize Global Variables */
 
@@ -70,6 +108,85 @@ int main(void) {
 
 	software_uart_init( 3 );
 
+#if ADC_UART_STREAM
+	/* Counter/Timer */
+
+	// Counter Reset
+	TCNT0 = 0;
+
+	// Set TOP for CTC Mode
+	OCR0A = ADC_UART_STREAM_TOP;
+
+	// Select CTC Mode (2), No Interrupt, Compare Match A Flag Triggers ADC
+	TCCR0A = _BV(WGM01);
+
+	/* ADC */
+
+	// Set ADC, Vcc as Reference, ADLAR, ADC1 (PB2) for First Conversion
+	ADMUX = _BV(ADLAR)|select_adc_channel_1;
+
+	// Auto Trigger Source: Timer/Counter0 Compare Match A
+	ADCSRB = _BV(ADTS1)|_BV(ADTS0);
+
+	// ADC Enable, ADC Auto Trigger Enable, Prescaler 64 to Have ADC Clock 150Khz, 13 ADC Clocks (832 Clocks) per Conversion
+	ADCSRA = _BV(ADEN)|_BV(ADATE)|_BV(ADPS2)|_BV(ADPS1);
+
+	// Start Counter with I/O-Clock 9.6MHz / ( 64 * (ADC_UART_STREAM_TOP + 1) ) = 937.5Hz, or 9.6MHz / ( 256 * (ADC_UART_STREAM_TOP + 1) ) = Approx. 407.6Hz in Telemetry
+	TCCR0B = ADC_UART_STREAM_PRESCALER;
+
+	while(1) {
+#if ADC_UART_TELEMETRY
+		while( ! (TIFR0 & _BV(OCF0A)) ); // Wait for Tick, Conversion of Channel 1 Is Started by Hardware
+		TIFR0 = _BV(OCF0A); // Clear Compare Match A Flag by Logic One to Trigger Next Conversion
+		software_uart_tx( TELEMETRY_SYNC, software_uart_tx_pin );
+		while( ! (ADCSRA & adc_complete) );
+		ADCSRA |= adc_complete; // Clear ADC Interrupt Flag by Logic One
+		value_adc_channel_1_low = ADCL; // Read Low Bits First
+		value_adc_channel_1_high = ADCH; // ADC[9:0] Will Be Updated After High Bits Are Read
+		ADMUX = (ADMUX & clear_adc_channel)|select_adc_channel_2;
+		ADCSRA |= _BV(ADSC); // Start Conversion of Channel 2 during Transmission
+		software_uart_tx( TELEMETRY_TYPE_ADC, software_uart_tx_pin );
+		software_uart_tx( ADC_UART_TELEMETRY_LENGTH, software_uart_tx_pin );
+		while( ! (ADCSRA & adc_complete) );
+		ADCSRA |= adc_complete; // Clear ADC Interrupt Flag by Logic One
+		value_adc_channel_2_low = ADCL; // Read Low Bits First
+		value_adc_channel_2_high = ADCH; // ADC[9:0] Will Be Updated After High Bits Are Read
+		ADMUX = (ADMUX & clear_adc_channel)|select_adc_channel_1; // For Next Tick
+		telemetry_payload[0] = telemetry_sequence++;
+		telemetry_payload[1] = value_adc_channel_1_high<<2|value_adc_channel_1_low>>6;
+		telemetry_payload[2] = value_adc_channel_1_high>>6;
+		telemetry_payload[3] = value_adc_channel_2_high<<2|value_adc_channel_2_low>>6;
+		telemetry_payload[4] = value_adc_channel_2_high>>6;
+		telemetry_frame_length = telemetry_make( telemetry_frame, TELEMETRY_TYPE_ADC, telemetry_payload, ADC_UART_TELEMETRY_LENGTH );
+		// Sync, Type, and Length Are Already Sent
+		for ( uint8_t i = 3; i < telemetry_frame_length; i++ ) software_uart_tx( telemetry_frame[i], software_uart_tx_pin );
+#else
+		while( ! (TIFR0 & _BV(OCF0A)) ); // Wait for Tick, Conversion of Channel 1 Is Started by Hardware
+		TIFR0 = _BV(OCF0A); // Clear Compare Match A Flag by Logic One to Trigger Next Conversion
+		if ( stream_is_second ) {
+			software_uart_tx( stream_channel_2_first, software_uart_tx_pin ); // First Byte for ADC Channel 2 of Previous Frame
+			software_uart_tx( stream_channel_2_second, software_uart_tx_pin ); // Second Byte for ADC Channel 2 of Previous Frame
+		}
+		while( ! (ADCSRA & adc_complete) );
+		ADCSRA |= adc_complete; // Clear ADC Interrupt Flag by Logic One
+		value_adc_channel_1_low = ADCL; // Read Low Bits First
+		value_adc_channel_1_high = ADCH; // ADC[9:0] Will Be Updated After High Bits Are Read
+		ADMUX = (ADMUX & clear_adc_channel)|select_adc_channel_2;
+		ADCSRA |= _BV(ADSC); // Start Conversion of Channel 2 during Transmission
+		software_uart_tx( 0x80|1<<5|(stream_sequence&0xC)<<1|value_adc_channel_1_high>>5, software_uart_tx_pin ); // First Byte for ADC Channel 1
+		software_uart_tx( 0x7F&(value_adc_channel_1_high<<2|value_adc_channel_1_low>>6), software_uart_tx_pin ); // Second Byte for ADC Channel 1
+		while( ! (ADCSRA & adc_complete) );
+		ADCSRA |= adc_complete; // Clear ADC Interrupt Flag by Logic One
+		value_adc_channel_2_low = ADCL; // Read Low Bits First
+		value_adc_channel_2_high = ADCH; // ADC[9:0] Will Be Updated After High Bits Are Read
+		ADMUX = (ADMUX & clear_adc_channel)|select_adc_channel_1; // For Next Tick
+		stream_channel_2_first = 0x80|2<<5|(stream_sequence&0x3)<<3|value_adc_channel_2_high>>5;
+		stream_channel_2_second = 0x7F&(value_adc_channel_2_high<<2|value_adc_channel_2_low>>6);
+		stream_sequence++;
+		stream_is_second = 1;
+#endif
+	}
+#else
 	/* ADC */
 
 	// Set ADC, Vcc as Reference, ADLAR
@@ -109,91 +226,25 @@ int main(void) {
 		value_adc_channel_2_low = ADCL; // Read Low Bits First
 		value_adc_channel_2_high = ADCH; // ADC[9:0] Will Be Updated After High Bits Are Read
 
-		software_uart_tx_38400( 0x80|1<<5|value_adc_channel_1_high>>5, software_uart_tx_pin ); // First Byte for ADC Channel 1
-		software_uart_tx_38400( 0x7F&(value_adc_channel_1_high<<2|value_adc_channel_1_low>>6), software_uart_tx_pin ); // Second Byte for ADC Channel 1
-		software_uart_tx_38400( 0x80|2<<5|value_adc_channel_2_high>>5, software_uart_tx_pin ); // First Byte for ADC Channel 2
-		software_uart_tx_38400( 0x7F&(value_adc_channel_2_high<<2|value_adc_channel_2_low>>6), software_uart_tx_pin ); // Second Byte for ADC Channel 2
+#if ADC_UART_TELEMETRY
+		telemetry_payload[0] = telemetry_sequence++;
+		telemetry_payload[1] = value_adc_channel_1_high<<2|value_adc_channel_1_low>>6;
+		telemetry_payload[2] = value_adc_channel_1_high>>6;
+		telemetry_payload[3] = value_adc_channel_2_high<<2|value_adc_channel_2_low>>6;
+		telemetry_payload[4] = value_adc_channel_2_high>>6;
+		telemetry_frame_length = telemetry_make( telemetry_frame, TELEMETRY_TYPE_ADC, telemetry_payload, ADC_UART_TELEMETRY_LENGTH );
+		for ( uint8_t i = 0; i < telemetry_frame_length; i++ ) software_uart_tx( telemetry_frame[i], software_uart_tx_pin );
+#else
+		software_uart_tx( 0x80|1<<5|value_adc_channel_1_high>>5, software_uart_tx_pin ); // First Byte for ADC Channel 1
+		software_uart_tx( 0x7F&(value_adc_channel_1_high<<2|value_adc_channel_1_low>>6), software_uart_tx_pin ); // Second Byte for ADC Channel 1
+		software_uart_tx( 0x80|2<<5|value_adc_channel_2_high>>5, software_uart_tx_pin ); // First Byte for ADC Channel 2
+		software_uart_tx( 0x7F&(value_adc_channel_2_high<<2|value_adc_channel_2_low>>6), software_uart_tx_pin ); // Second Byte for ADC Channel 2
+#endif
 		_delay_ms( 500 );
 	}
+#endif
 	return 0;
 }
 
 // For ADC Noise Reduction Mode
 EMPTY_INTERRUPT(ADC_vect);
-
-void software_uart_init( uint8_t portb_pin_number_for_tx ) {
-	PORTB |= _BV( portb_pin_number_for_tx );
-	DDRB |= _BV( portb_pin_number_for_tx );
-	_NOP();
-	software_uart_tx_pin = portb_pin_number_for_tx;
-}
-
-void software_uart_print_38400( char* string, uint16_t length, uint8_t portb_pin_number_for_tx ) {
-	for( uint16_t i = 0; i < length; i++ ) software_uart_tx_38400( string[i], portb_pin_number_for_tx );
-}
-
-void software_uart_tx_38400( uint8_t character, uint8_t portb_pin_number_for_tx ) {
-	/**
-	 * First Argument is r24, Second Argument is r22 (r25 to r8, Assign Even Number Registers)
-	 * r18-r27, r30-r31 are scratch registers.
-	 * r2-r17, r28-r29 need push/pop in the function.
-	 * r0 is temporary and r1 is zero.
-	 */
-	register const uint8_t count_delay asm("r18") = 59; // 59 * 4, 236 Clocks
-	register uint8_t count asm("r19");
-	register uint8_t set_bit_pin asm("r20") = _BV( portb_pin_number_for_tx );
-	register uint8_t clear_bit_pin asm("r21") = ~( set_bit_pin );;
-	register uint8_t i asm("r22") = 9;
-	asm volatile (
-			"clc" "\n\t" // Clear Carry Bit for Start Bit
-		"software_uart_tx_38400_forloop:" "\n\t" // 14 Clocks + Delay 236 Clocks
-			"in __tmp_reg__, %[portb]" "\n\t"
-			"brcc software_uart_tx_38400_forloop_carryclear" "\n\t" // From Result of lsr
-			"or __tmp_reg__, %[set_bit_pin]" "\n\t"
-			"rjmp software_uart_tx_38400_forloop_common" "\n\t"
-			"software_uart_tx_38400_forloop_carryclear:" "\n\t"
-				"and __tmp_reg__, %[clear_bit_pin]" "\n\t"
-				"nop" "\n\t"
-			"software_uart_tx_38400_forloop_common:" "\n\t"
-				"out %[portb], __tmp_reg__" "\n\t"
-				// count_delay * 4 Cycles
-				"mov %[count], %[count_delay]" "\n\t"
-				"software_uart_tx_38400_forloop_common_delay:" "\n\t"
-					"nop" "\n\t"
-					"subi %[count], 0x1" "\n\t"
-					"brne software_uart_tx_38400_forloop_common_delay" "\n\t"
-					"rjmp .+0" "\n\t" // Two Cycles
-				"subi %[i], 0x1" "\n\t"
-				"breq software_uart_tx_38400_stopbit" "\n\t" // Branch If Lower
-				"nop" "\n\t"
-				"lsr %[character]" "\n\t"
-				"rjmp software_uart_tx_38400_forloop" "\n\t"
-		"software_uart_tx_38400_stopbit:" "\n\t"
-			"in __tmp_reg__, %[portb]" "\n\t"
-			"or __tmp_reg__, %[set_bit_pin]" "\n\t"
-			"rjmp .+0" "\n\t" // Two Cycles
-			"rjmp .+0" "\n\t" // Two Cycles
-			"rjmp .+0" "\n\t" // Two Cycles
-			"out %[portb], __tmp_reg__" "\n\t"
-			//count_delay * 4 Cycles
-			"mov %[count], %[count_delay]" "\n\t"
-			"inc %[count]" "\n\t" // 60 * 4, 240 Clocks + 10 Clock from out to ret at Last
-			"software_uart_tx_38400_stopbit_delay:" "\n\t"
-				"nop" "\n\t"
-				"subi %[count], 0x1" "\n\t"
-				"brne software_uart_tx_38400_stopbit_delay" "\n\t"
-				"rjmp .+0" "\n\t" // Two Cycles
-				"rjmp .+0" "\n\t" // Two Cycles
-		/* Outputs */
-		:[count]"=d"(count),
-		 [i]"+d"(i)
-		/* Inputs */
-		:[portb]"I"(_SFR_IO_ADDR(PORTB)),
-		 [set_bit_pin]"r"(set_bit_pin),
-		 [clear_bit_pin]"r"(clear_bit_pin),
-		 [count_delay]"r"(count_delay),
-		 [character]"r"(character)
-		/* Clobber List */
-		:
-	);
-}
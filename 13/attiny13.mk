@@ -0,0 +1,111 @@
+##
+# Copyright 2021 Kenta Ishii
+# License: 3-Clause BSD License
+# SPDX Short Identifier: BSD-3-Clause
+##
+
+# Default Name of Program
+NAME ?= program_attiny13
+
+# Location of Folder Headers
+HEADER_GLOBAL := ../../
+HEADER_LOCAL := ../
+
+# Main C Code
+OBJ1 := main
+
+# Library C Code
+#OBJ2 := libary
+
+COMP := avr
+CC := $(COMP)-gcc
+AS := $(COMP)-as
+LINKER := $(COMP)-ld
+COPY := $(COMP)-objcopy
+DUMP := $(COMP)-objdump
+SIZE := $(COMP)-size
+
+ARCH := avr2
+MCU  := attiny13
+# Programmer
+PROG ?= linuxgpio
+INTERVAL ?= 100
+HFUSE ?= 0xFF
+# Unprogrammed CKDIV8, Internal 9.6MHz Clock
+LFUSE ?= 0x7A
+
+# Budget of Memory, Build Fails If Exceeded
+FLASH_SIZE := 1024
+SRAM_SIZE := 64
+# Estimated Bytes of Stack, Including Return Addresses and Registers Pushed in Interrupts
+STACK_ESTIMATE ?= 16
+# Static Analyzer of Stack Depth with -fstack-usage and Call Graph of Disassembly, Build Fails If Worst Case Exceeds SRAM
+PYTHON ?= python3
+STACK_ANALYZER := $(HEADER_GLOBAL)host/stack_usage.py
+
+# Profile of Optimization: default, lto, call-prologues, or whole-program
+# Use "make profiles" to compare sizes of all profiles.
+PROFILE ?= default
+PROFILES := default lto call-prologues whole-program
+ifeq ($(PROFILE),default)
+PROFILE_FLAGS :=
+else ifeq ($(PROFILE),lto)
+PROFILE_FLAGS := -flto
+else ifeq ($(PROFILE),call-prologues)
+PROFILE_FLAGS := -mcall-prologues
+else ifeq ($(PROFILE),whole-program)
+PROFILE_FLAGS := -fwhole-program
+else
+$(error Unknown PROFILE "$(PROFILE)", Use One of $(PROFILES))
+endif
+
+# "$@" means the target and $^ means all of dependencies and $< is first one.
+# If you meets "make: `main' is up to date.", use "touch" command to renew.
+# "$?" means ones which are newer than the target.
+# Make sure to use tab in command line
+
+# Delete Hex File If Checks of Budget Fail
+.DELETE_ON_ERROR:
+
+# Make Hex File (Main Target) and Disassembled Dump File
+.PHONY: all
+all: $(NAME).hex
+$(NAME).hex: $(NAME).elf
+	@$(SIZE) -A $< | awk -v name=$(NAME) -v profile=$(PROFILE) -v flash=$(FLASH_SIZE) -v sram=$(SRAM_SIZE) -v stack=$(STACK_ESTIMATE) '\
+		$$1 == ".text" { text = $$2 } $$1 == ".data" { data = $$2 } $$1 == ".bss" { bss = $$2 } \
+		END { \
+			printf "%s (%s): Flash %d/%d Bytes (.text %d + .data %d), SRAM %d/%d Bytes (.data %d + .bss %d + Stack %d)\n", \
+				name, profile, text + data, flash, text, data, data + bss + stack, sram, data, bss, stack; \
+			if ( text + data > flash ) { print "Error: Flash exceeds the budget."; exit 1 } \
+			if ( data + bss + stack > sram ) { print "Error: SRAM exceeds the budget."; exit 1 } \
+		}'
+	$(COPY) $< $@ -O ihex -R .eeprom
+	$(DUMP) -D -m $(ARCH) $< > $(NAME).dump
+	@$(PYTHON) $(STACK_ANALYZER) --name $(NAME) --dump $(NAME).dump --su $$(ls *.su 2>/dev/null) --sram $(SRAM_SIZE) \
+		--size "$$($(SIZE) -A $< | awk '$$1 == ".data" { data = $$2 } $$1 == ".bss" { bss = $$2 } END { print data + 0, bss + 0 }')"
+
+$(NAME).elf: $(OBJ1).o
+	$(LINKER) $^ -o $@ -Map $(NAME).map
+
+# Make Object File from C
+$(OBJ1).o: $(OBJ1).c
+	$(CC) $< -o $@ -mmcu=$(MCU) -Wall -Os -fstack-usage $(PROFILE_FLAGS) -I$(HEADER_GLOBAL) -I$(HEADER_LOCAL)
+
+# Build with each profile to compare sizes, the last profile remains
+.PHONY: profiles
+profiles:
+	@for profile in $(PROFILES); do \
+		rm -f $(OBJ1).o $(NAME).elf $(NAME).map $(NAME).hex $(NAME).dump *.su; \
+		$(MAKE) --no-print-directory -s all PROFILE=$$profile || echo "$(NAME) ($$profile): Failed"; \
+	done
+
+.PHONY: warn
+warn: all clean
+
+.PHONY: clean
+clean:
+	rm $(OBJ1).o $(NAME).elf $(NAME).map $(NAME).hex $(NAME).dump $(wildcard *.su)
+
+.PHONY: install
+install:
+	sudo avrdude -p $(MCU) -c $(PROG) -v -i $(INTERVAL) -U hfuse:w:$(HFUSE):m -U lfuse:w:$(LFUSE):m -U flash:w:$(NAME).hex:a
@@ -12,6 +12,7 @@
 #include <avr/io.h>
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <avr/sleep.h>
 #include <util/delay.h>
 #include <util/delay_basic.h>
@@ -23,10 +24,55 @@
  * PB4 as Output Bit[1] of Encoder
  * PB1 as Output Bit[2] of Encoder
  * PB0 as Output Bit[3] of Encoder
- * Input from PB2 (ADC1): Bit[3:0] of the encoder is calculated through logical shift left 6 times to ADC Value (10-bit).
+ * Input from PB2 (ADC1): Bit[3:0] of the encoder is calculated through logical shift right 6 times to ADC Value (10-bit).
+ * Note: ADC value is the average of ENCODER_OVERSAMPLE samples. Each sample takes 13 ADC clocks (Approx. 86.67us).
+ *       The output changes only if the average passes the boundary of the current bucket (64 in 10-bit) by the margin of the boundary,
+ *       so the output doesn't chatter at boundaries. ENCODER_HYSTERESIS lists margins of 15 boundaries, e.g., wider margins for noisy positions.
+ *       Each margin must be less than 32 not to skip a bucket.
+ *       If ENCODER_GRAY_CODE is 1, Bit[3:0] is Gray code, i.e., only one bit changes at a time between adjacent buckets.
+ *       The output is updated at approx. 360Hz with ENCODER_DELAY 2 (2ms + 8 Samples).
  */
 
 #define SAMPLE_RATE (double)(F_CPU / 510 * 64) // Approx. 294.117647 Samples per Seconds
+#define ENCODER_OVERSAMPLE_SHIFT 3 // 2^3 = 8 Samples
+#define ENCODER_OVERSAMPLE (1 << ENCODER_OVERSAMPLE_SHIFT)
+#define ENCODER_HYSTERESIS 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8 // Margins of Boundaries between Buckets 0/1 to 14/15, In 10-bit ADC Value
+#define ENCODER_GRAY_CODE 0 // 0 = Binary, 1 = Gray Code
+#define ENCODER_DELAY 2 // Milliseconds between Updates
+#define ENCODER_BUCKET_SHIFT 6 // 10-bit to 4-bit
+
+/**
+ * Bit[3:0] of Encoder to PORTB
+ * PB2 (ADC1) and PB5 (RESET) are inputs without pull-up, so PORTB is written at once with a single "out".
+ */
+uint8_t const encoder_portb_array[16] PROGMEM = { // Array in Program Space
+	0,
+	_BV(PB3),
+	_BV(PB4),
+	_BV(PB4)|_BV(PB3),
+	_BV(PB1),
+	_BV(PB1)|_BV(PB3),
+	_BV(PB1)|_BV(PB4),
+	_BV(PB1)|_BV(PB4)|_BV(PB3),
+	_BV(PB0),
+	_BV(PB0)|_BV(PB3),
+	_BV(PB0)|_BV(PB4),
+	_BV(PB0)|_BV(PB4)|_BV(PB3),
+	_BV(PB0)|_BV(PB1),
+	_BV(PB0)|_BV(PB1)|_BV(PB3),
+	_BV(PB0)|_BV(PB1)|_BV(PB4),
+	_BV(PB0)|_BV(PB1)|_BV(PB4)|_BV(PB3)
+};
+
+// Margin of Each Boundary, Index Is the Lower Bucket of the Boundary
+uint8_t const encoder_hysteresis_array[15] PROGMEM = { ENCODER_HYSTERESIS }; // Array in Program Space
+
+// Maximum of 15 Margins, Fails If ENCODER_HYSTERESIS Doesn't Have 15 Margins
+#define ENCODER_MAX(a,b) ((a) > (b) ? (a) : (b))
+#define ENCODER_MAX_15(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o) ENCODER_MAX(ENCODER_MAX(ENCODER_MAX(ENCODER_MAX(a,b),ENCODER_MAX(c,d)),ENCODER_MAX(ENCODER_MAX(e,f),ENCODER_MAX(g,h))),ENCODER_MAX(ENCODER_MAX(ENCODER_MAX(i,j),ENCODER_MAX(k,l)),ENCODER_MAX(ENCODER_MAX(m,n),o)))
+#define ENCODER_HYSTERESIS_MAX(...) ENCODER_MAX_15(__VA_ARGS__)
+
+_Static_assert( ENCODER_HYSTERESIS_MAX(ENCODER_HYSTERESIS) < (1 << (ENCODER_BUCKET_SHIFT - 1)), "ENCODER_HYSTERESIS must be less than half of a bucket." );
 
 /* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
 
@@ -38,7 +84,10 @@ int main(void) {
 
 	uint8_t const select_adc_channel_1 = _BV(MUX0); // ADC1 (PB2)
 	uint8_t const clear_adc_channel = ~(_BV(MUX1)|_BV(MUX0));
-	uint8_t value_adc_channel_1_high = 0; // Bit[7:0] Is ADC[9:2]
+	uint8_t encoder_code; // Bit[3:0] Is Bucket in Binary or Gray Code
+	uint16_t value_adc_channel_1_sum; // Sum of Samples
+	int16_t value_adc_channel_1_average; // 10-bit
+	uint8_t encoder_bucket = 0;
 	uint8_t encoder_output;
 
 	/* Initialize Global Variables */
@@ -61,8 +110,8 @@ int main(void) {
 	// For Noise Reduction of ADC, Disable All Digital Input Buffers
 	DIDR0 = _BV(ADC0D)|_BV(ADC2D)|_BV(ADC3D)|_BV(ADC1D)|_BV(AIN1D)|_BV(AIN0D);
 
-	// Set ADC, Vcc as Reference, ADLAR
-	ADMUX = _BV(ADLAR);
+	// Set ADC, Vcc as Reference, Right Adjusted for 10-bit
+	ADMUX = 0;
 
 	// ADC Enable, ADC Interrupt Enable, Prescaler 64 to Have ADC Clock 150Khz
 	// Memo: Set more speed for ADC Clock (600Khz), although it affects the absolute resolution. Set ADLAR and get only ADCH for 8 bit resolution.
@@ -73,36 +122,31 @@ int main(void) {
 
 	while(1) {
 		ADMUX |= select_adc_channel_1;
-		sleep_enable();
-		sei(); // Start to Issue Interrupt
-		sleep_cpu();
-		sleep_disable();
-		cli(); // Stop to Issue Interrupt
-		ADMUX &= clear_adc_channel;
-		value_adc_channel_1_high = ADCH >> 4; // ADC[9:0] Will Be Updated After High Bits Are Read
-		encoder_output = PORTB;
-		if ( value_adc_channel_1_high & 0b0001 ) {
-			encoder_output |= _BV(PB3);
-		} else {
-			encoder_output &= ~(_BV(PB3));
+		value_adc_channel_1_sum = 0;
+		for ( uint8_t i = 0; i < ENCODER_OVERSAMPLE; i++ ) {
+			sleep_enable();
+			sei(); // Start to Issue Interrupt
+			sleep_cpu();
+			sleep_disable();
+			cli(); // Stop to Issue Interrupt
+			value_adc_channel_1_sum += ADC; // Read Low Bits First and High Bits
 		}
-		if ( value_adc_channel_1_high & 0b0010 ) {
-			encoder_output |= _BV(PB4);
-		} else {
-			encoder_output &= ~(_BV(PB4));
-		}
-		if ( value_adc_channel_1_high & 0b0100 ) {
-			encoder_output |= _BV(PB1);
-		} else {
-			encoder_output &= ~(_BV(PB1));
-		}
-		if ( value_adc_channel_1_high & 0b1000 ) {
-			encoder_output |= _BV(PB0);
-		} else {
-			encoder_output &= ~(_BV(PB0));
+		ADMUX &= clear_adc_channel;
+		value_adc_channel_1_average = value_adc_channel_1_sum >> ENCODER_OVERSAMPLE_SHIFT;
+		// Hysteresis: Change Bucket Only If Average Is Out of Current Bucket by the Margin of the Crossed Boundary
+		if ( encoder_bucket && value_adc_channel_1_average < (int16_t)(encoder_bucket << ENCODER_BUCKET_SHIFT) - pgm_read_byte(&(encoder_hysteresis_array[encoder_bucket - 1])) ) {
+			encoder_bucket = value_adc_channel_1_average >> ENCODER_BUCKET_SHIFT;
+		} else if ( encoder_bucket < 15 && value_adc_channel_1_average >= (int16_t)((encoder_bucket + 1) << ENCODER_BUCKET_SHIFT) + pgm_read_byte(&(encoder_hysteresis_array[encoder_bucket])) ) {
+			encoder_bucket = value_adc_channel_1_average >> ENCODER_BUCKET_SHIFT;
 		}
+#if ENCODER_GRAY_CODE
+		encoder_code = encoder_bucket ^ (encoder_bucket >> 1);
+#else
+		encoder_code = encoder_bucket;
+#endif
+		encoder_output = pgm_read_byte(&(encoder_portb_array[encoder_code]));
 		PORTB = encoder_output;
-		_delay_ms(20);
+		_delay_ms(ENCODER_DELAY);
 	}
 	return 0;
 }
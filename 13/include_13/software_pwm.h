@@ -0,0 +1,135 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Software PWM for ATtiny13 with a sorted list of compare events
+ * Timer0 runs in Normal Mode (0) with I/O-Clock 9.6MHz / ( 256 * 64 ) = 585.9375Hz.
+ * Overflow sets all outputs which have non-zero duty, and Compare Match A clears outputs in ascending order of duty.
+ * Channels with the same duty share one event, so the number of Compare Match A interrupts per period is the number of distinct duties.
+ * Duty: 0 = Off, 1-254 = Duty / 256, 255 = Always On
+ * Events closer than SOFTWARE_PWM_EVENT_MARGIN counts are handled in one interrupt, so a difference of small duties may be up to 1 count.
+ *
+ * Define SOFTWARE_PWM_PINS to assign channels to pins before including this header, e.g., {_BV(PB0),_BV(PB1),_BV(PB2),_BV(PB4)}.
+ * Call software_pwm_handler_overflow() in ISR(TIM0_OVF_vect) and software_pwm_handler_compare() in ISR(TIM0_COMPA_vect).
+ * Set software_pwm_duty[], and call software_pwm_update() to apply duties from the next period.
+ */
+
+#ifndef SOFTWARE_PWM_CHANNELS
+#define SOFTWARE_PWM_CHANNELS 4 // Up to 5
+#endif
+#ifndef SOFTWARE_PWM_PINS
+#define SOFTWARE_PWM_PINS {_BV(PB0),_BV(PB1),_BV(PB2),_BV(PB4)}
+#endif
+#define SOFTWARE_PWM_EVENT_MARGIN 1 // Counts of Timer0 to Handle Next Event Immediately
+
+_Static_assert( SOFTWARE_PWM_CHANNELS >= 1 && SOFTWARE_PWM_CHANNELS <= 5, "SOFTWARE_PWM_CHANNELS must be 1 to 5." );
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint8_t software_pwm_duty[SOFTWARE_PWM_CHANNELS];
+// Two banks of events, one is used by handlers and another is made by software_pwm_update()
+uint8_t software_pwm_event_time[2][SOFTWARE_PWM_CHANNELS];
+uint8_t software_pwm_event_mask[2][SOFTWARE_PWM_CHANNELS];
+uint8_t software_pwm_event_count[2];
+uint8_t software_pwm_on_mask[2];
+uint8_t software_pwm_all_mask;
+volatile uint8_t software_pwm_bank;
+volatile uint8_t software_pwm_is_update;
+volatile uint8_t software_pwm_event_index;
+
+uint8_t const software_pwm_pin_array[SOFTWARE_PWM_CHANNELS] PROGMEM = SOFTWARE_PWM_PINS; // Array in Program Space
+
+static inline void software_pwm_init() {
+	software_pwm_all_mask = 0;
+	for ( uint8_t i = 0; i < SOFTWARE_PWM_CHANNELS; i++ ) {
+		software_pwm_duty[i] = 0;
+		software_pwm_all_mask |= pgm_read_byte(&(software_pwm_pin_array[i]));
+	}
+	software_pwm_event_count[0] = 0;
+	software_pwm_on_mask[0] = 0;
+	software_pwm_bank = 0;
+	software_pwm_is_update = 0;
+	software_pwm_event_index = 0;
+	PORTB &= ~(software_pwm_all_mask);
+	DDRB |= software_pwm_all_mask;
+	// Counter Reset
+	TCNT0 = 0;
+	// Select Normal Mode (0) and No Output
+	TCCR0A = 0;
+	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIM0_OVF_vect)" and Compare Match A Interrupt for "ISR(TIM0_COMPA_vect)"
+	TIMSK0 |= _BV(OCIE0A)|_BV(TOIE0);
+	// Start Counter with I/O-Clock 9.6MHz / ( 256 * 64 ) = 585.9375Hz
+	TCCR0B = _BV(CS01)|_BV(CS00);
+}
+
+/**
+ * Make events from software_pwm_duty[] with insertion sort, which is enough for 5 channels.
+ * Wait for the previous update to be applied at the next overflow, because the spare bank is in use until then.
+ */
+static inline void software_pwm_update() {
+	uint8_t bank;
+	uint8_t count = 0;
+	uint8_t on_mask = 0;
+	uint8_t duty;
+	uint8_t mask;
+	uint8_t i;
+	while ( software_pwm_is_update );
+	bank = software_pwm_bank ^ 0b1;
+	for ( uint8_t channel = 0; channel < SOFTWARE_PWM_CHANNELS; channel++ ) {
+		duty = software_pwm_duty[channel];
+		if ( ! duty ) continue;
+		mask = pgm_read_byte(&(software_pwm_pin_array[channel]));
+		on_mask |= mask;
+		if ( duty == 0xFF ) continue; // Always On
+		for ( i = 0; i < count; i++ ) {
+			if ( software_pwm_event_time[bank][i] >= duty ) break;
+		}
+		if ( i < count && software_pwm_event_time[bank][i] == duty ) {
+			software_pwm_event_mask[bank][i] |= mask;
+			continue;
+		}
+		for ( uint8_t j = count; j > i; j-- ) {
+			software_pwm_event_time[bank][j] = software_pwm_event_time[bank][j - 1];
+			software_pwm_event_mask[bank][j] = software_pwm_event_mask[bank][j - 1];
+		}
+		software_pwm_event_time[bank][i] = duty;
+		software_pwm_event_mask[bank][i] = mask;
+		count++;
+	}
+	software_pwm_event_count[bank] = count;
+	software_pwm_on_mask[bank] = on_mask;
+	software_pwm_is_update = 1;
+}
+
+// Clear outputs of due events, and set Output Compare A for the next event.
+static inline void software_pwm_next() {
+	uint8_t bank = software_pwm_bank;
+	uint8_t index = software_pwm_event_index;
+	while ( index < software_pwm_event_count[bank] ) {
+		if ( software_pwm_event_time[bank][index] > TCNT0 + SOFTWARE_PWM_EVENT_MARGIN ) { // Promoted to int, No Wrap Around
+			OCR0A = software_pwm_event_time[bank][index];
+			TIFR0 = _BV(OCF0A); // Clear Compare Match A Flag by Logic One, It May Be Set by Previous Value
+			break;
+		}
+		PORTB &= ~(software_pwm_event_mask[bank][index]);
+		index++;
+	}
+	software_pwm_event_index = index;
+}
+
+static inline void software_pwm_handler_overflow() {
+	if ( software_pwm_is_update ) {
+		software_pwm_bank ^= 0b1;
+		software_pwm_is_update = 0;
+	}
+	PORTB = (PORTB & ~(software_pwm_all_mask))|software_pwm_on_mask[software_pwm_bank];
+	software_pwm_event_index = 0;
+	software_pwm_next();
+}
+
+static inline void software_pwm_handler_compare() {
+	software_pwm_next();
+}
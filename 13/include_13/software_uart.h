@@ -0,0 +1,183 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Software UART Tx with a busy loop for ATtiny13, which has no hardware to shift bits.
+ * The number of clocks per bit is F_CPU divided by the baud rate.
+ * In the loop, one bit takes 12 clocks for the process, 4 clocks per count of the delay, and 0-3 clocks of padding (NOPs).
+ *   Clocks per Bit = 12 + (Count of Delay * 4) + Padding
+ * e.g., 9600 baud at 9.6Mhz: 1000 clocks = 12 + (247 * 4) + 0, 115200 baud at 9.6Mhz: 83 clocks = 12 + (17 * 4) + 3.
+ * The count of the delay must be 1 to 255, so 9600 baud to 600000 baud are available at 9.6Mhz.
+ * Interrupts must be disabled while transmitting, otherwise the timing is corrupted.
+ * Define SOFTWARE_UART_TIMER before including this header to use Software UART Tx driven by Timer0 instead.
+ */
+
+/**
+ * The error of baud rate is caused by rounding off clocks per bit.
+ * The acceptable error is shared by Rx device and Tx device, so the error is limited to 1.875 percents (See 85/include_85/software_uart.h).
+ */
+
+#ifndef SOFTWARE_UART_BAUD_RATE
+#define SOFTWARE_UART_BAUD_RATE 9600 // Define before Including This Header to Change Baud Rate
+#endif
+#define SOFTWARE_UART_ERROR_TOLERANCE 1875ULL // Parts per 100000, 1.875 Percents
+#define SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) ((F_CPU + ((baud_rate) >> 1)) / (baud_rate)) // Round Off
+#define SOFTWARE_UART_COUNT_DELAY( baud_rate ) ((SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) - 12) >> 2)
+#define SOFTWARE_UART_COUNT_PADDING( baud_rate ) ((SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) - 12) & 0x3)
+#define SOFTWARE_UART_ERROR( baud_rate ) ((SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) * (baud_rate) > F_CPU) ? (SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) * (baud_rate) - F_CPU) : (F_CPU - SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) * (baud_rate)))
+
+/**
+ * Define Software UART Tx Function
+ * name: Function Name, void name( uint8_t character, uint8_t portb_pin_number_for_tx )
+ * baud_rate: Baud Rate, the build fails if the baud rate is not available at F_CPU.
+ */
+#define SOFTWARE_UART_TX_DEFINE( name, baud_rate ) \
+_Static_assert( SOFTWARE_UART_CLOCKS_PER_BIT( baud_rate ) >= 16 && SOFTWARE_UART_COUNT_DELAY( baud_rate ) <= 255, "Baud rate is out of range at F_CPU." ); \
+_Static_assert( SOFTWARE_UART_ERROR( baud_rate ) * 100000ULL <= F_CPU * SOFTWARE_UART_ERROR_TOLERANCE, "Error of baud rate exceeds tolerance at F_CPU." ); \
+__attribute__((noinline)) void name( uint8_t character, uint8_t portb_pin_number_for_tx ) { \
+	/** \
+	 * First Argument is r24, Second Argument is r22 (r25 to r8, Assign Even Number Registers) \
+	 * r18-r27, r30-r31 are scratch registers. \
+	 * r2-r17, r28-r29 need push/pop in the function. \
+	 * r0 is temporary and r1 is zero. \
+	 */ \
+	uint8_t count; \
+	uint8_t set_bit_pin = _BV( portb_pin_number_for_tx ); \
+	uint8_t clear_bit_pin = ~( set_bit_pin ); \
+	uint8_t i = 9; \
+	asm volatile ( \
+			"clc" "\n\t" /* Clear Carry Bit for Start Bit */ \
+		"1:" "\n\t" /* Loop for Start Bit and Data Bits, 12 Clocks + Delay + Padding */ \
+			"in __tmp_reg__, %[portb]" "\n\t" \
+			"brcc 2f" "\n\t" /* From Result of lsr */ \
+			"or __tmp_reg__, %[set_bit_pin]" "\n\t" \
+			"rjmp 3f" "\n\t" \
+			"2:" "\n\t" /* Carry Clear */ \
+				"and __tmp_reg__, %[clear_bit_pin]" "\n\t" \
+				"nop" "\n\t" \
+			"3:" "\n\t" /* Common */ \
+				"out %[portb], __tmp_reg__" "\n\t" \
+				/* count_delay * 4 Clocks - 1 Clock */ \
+				"ldi %[count], %[count_delay]" "\n\t" \
+				"4:" "\n\t" \
+					"nop" "\n\t" \
+					"subi %[count], 0x1" "\n\t" \
+					"brne 4b" "\n\t" \
+				".rept %[count_padding]" "\n\t" \
+					"nop" "\n\t" \
+				".endr" "\n\t" \
+				"subi %[i], 0x1" "\n\t" \
+				"breq 5f" "\n\t" /* Branch If Stop Bit */ \
+				"nop" "\n\t" \
+				"lsr %[character]" "\n\t" \
+				"rjmp 1b" "\n\t" \
+		"5:" "\n\t" /* Stop Bit */ \
+			"in __tmp_reg__, %[portb]" "\n\t" \
+			"or __tmp_reg__, %[set_bit_pin]" "\n\t" \
+			"rjmp .+0" "\n\t" /* Two Clocks */ \
+			"rjmp .+0" "\n\t" /* Two Clocks */ \
+			"rjmp .+0" "\n\t" /* Two Clocks */ \
+			"out %[portb], __tmp_reg__" "\n\t" \
+			/* (count_delay + 1) * 4 Clocks, Longer Than One Bit with Clocks to ret */ \
+			"ldi %[count], %[count_delay]" "\n\t" \
+			"inc %[count]" "\n\t" /* 0 Means 256 Counts If count_delay Is 255 */ \
+			"6:" "\n\t" \
+				"nop" "\n\t" \
+				"subi %[count], 0x1" "\n\t" \
+				"brne 6b" "\n\t" \
+			".rept %[count_padding]" "\n\t" \
+				"nop" "\n\t" \
+			".endr" "\n\t" \
+			"rjmp .+0" "\n\t" /* Two Clocks */ \
+		/* Outputs */ \
+		:[count]"=&d"(count), \
+		 [i]"+d"(i), \
+		 [character]"+r"(character) \
+		/* Inputs */ \
+		:[portb]"I"(_SFR_IO_ADDR(PORTB)), \
+		 [set_bit_pin]"r"(set_bit_pin), \
+		 [clear_bit_pin]"r"(clear_bit_pin), \
+		 [count_delay]"n"(SOFTWARE_UART_COUNT_DELAY( baud_rate )), \
+		 [count_padding]"n"(SOFTWARE_UART_COUNT_PADDING( baud_rate )) \
+		/* Clobber List */ \
+		: \
+	); \
+}
+
+#ifndef SOFTWARE_UART_TIMER
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint8_t software_uart_tx_pin;
+
+void software_uart_init( uint8_t portb_pin_number_for_tx ) {
+	PORTB |= _BV( portb_pin_number_for_tx );
+	DDRB |= _BV( portb_pin_number_for_tx );
+	_NOP();
+	software_uart_tx_pin = portb_pin_number_for_tx;
+}
+
+SOFTWARE_UART_TX_DEFINE( software_uart_tx, SOFTWARE_UART_BAUD_RATE )
+
+void software_uart_print( char* string, uint16_t length, uint8_t portb_pin_number_for_tx ) {
+	for( uint16_t i = 0; i < length; i++ ) software_uart_tx( string[i], portb_pin_number_for_tx );
+}
+
+#else
+
+/**
+ * Software UART Tx driven by Timer0, which is safe with other interrupts.
+ * Call software_uart_handler_tx() in an interrupt of Timer0, e.g., "ISR(TIM0_COMPB_vect)".
+ * Timer0 is shared with PWM output. OCR0B at the middle of the period keeps the interrupt away from "ISR(TIM0_OVF_vect)".
+ * The interrupt occurs SOFTWARE_UART_TIMER_TICK_RATE times per second, and a 16-bit phase accumulator decides edges of bits.
+ * The average baud rate is exact, and each edge has jitter up to one tick, which doesn't accumulate.
+ * e.g., 37500 ticks (Fast PWM at 9.6Mhz without prescaler) and 4800 baud: the jitter is up to 12.8 percents of one bit.
+ * To transmit, set software_uart_tx_byte, then set SOFTWARE_UART_TX_COUNT_START to software_uart_tx_count if it's zero.
+ */
+
+#ifndef SOFTWARE_UART_PIN_TX
+#define SOFTWARE_UART_PIN_TX PB3
+#endif
+#ifndef SOFTWARE_UART_TIMER_TICK_RATE
+#define SOFTWARE_UART_TIMER_TICK_RATE (F_CPU / 256) // Overflows of 8-bit Timer0 without Prescaler
+#endif
+#define SOFTWARE_UART_TIMER_PHASE_DELTA ((uint16_t)((65536ULL * SOFTWARE_UART_BAUD_RATE + (SOFTWARE_UART_TIMER_TICK_RATE >> 1)) / SOFTWARE_UART_TIMER_TICK_RATE))
+#define SOFTWARE_UART_TX_COUNT_START 10 // Start Bit, 8 Data Bits, and Stop Bit
+
+_Static_assert( SOFTWARE_UART_BAUD_RATE * 2 <= SOFTWARE_UART_TIMER_TICK_RATE, "Baud rate is too high for ticks of Timer0." );
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+volatile uint8_t software_uart_tx_byte;
+volatile uint8_t software_uart_tx_count;
+volatile uint16_t software_uart_tx_phase;
+
+static inline void software_uart_init() {
+	PORTB |= _BV(SOFTWARE_UART_PIN_TX);
+	DDRB |= _BV(SOFTWARE_UART_PIN_TX);
+	software_uart_tx_byte = 0;
+	software_uart_tx_count = 0;
+	software_uart_tx_phase = 0;
+}
+
+static inline void software_uart_handler_tx() {
+	if ( (software_uart_tx_phase += SOFTWARE_UART_TIMER_PHASE_DELTA) >= SOFTWARE_UART_TIMER_PHASE_DELTA ) return; // Return If No Carry
+	if ( software_uart_tx_count >= SOFTWARE_UART_TX_COUNT_START ) { // Start Bit
+		PORTB &= ~(_BV(SOFTWARE_UART_PIN_TX));
+	} else if ( software_uart_tx_count > 1 ) { // Data Bits from LSB
+		if ( software_uart_tx_byte & 0b1 ) {
+			PORTB |= _BV(SOFTWARE_UART_PIN_TX);
+		} else {
+			PORTB &= ~(_BV(SOFTWARE_UART_PIN_TX));
+		}
+		software_uart_tx_byte >>= 1;
+	} else { // Stop Bit and Idle
+		PORTB |= _BV(SOFTWARE_UART_PIN_TX);
+	}
+	if ( software_uart_tx_count ) software_uart_tx_count--;
+}
+
+#endif
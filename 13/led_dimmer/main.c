@@ -12,6 +12,7 @@
 #include <avr/io.h>
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 #include <util/delay_basic.h>
 
@@ -22,14 +23,60 @@
  * PWM Output 2 from PB1 (OC0B)
  * Input from PB2 (ADC1) for Dimming PWM Output 1, ADC Value 0 Means Turning Off, ADC Value 255 Means Full Power
  * Input from PB4 (ADC2) for Dimming PWM Output 2, ADC Value 0 Means Turning Off, ADC Value 255 Means Full Power
+ * Note: ADC value is corrected by the gamma table to have the brightness in 8.8 fixed point (Bit[15:8] Is Duty, Bit[7:0] Is Fraction).
+ *       Bit[7:(8 - DITHER_BITS)] of the fraction is added to a sigma-delta accumulator on every overflow of Timer0,
+ *       and the carry of the accumulator adds one to the duty. The resolution of brightness is (8 + DITHER_BITS) bits.
+ *       The PWM frequency is kept at approx. 294.12Hz. The pattern of dithering repeats at 294.12Hz / 2^DITHER_BITS at least,
+ *       which is approx. 73.53Hz with DITHER_BITS 2. DITHER_BITS 3 (11-bit) may show flicker at the low end.
  */
 
 #define SAMPLE_RATE (double)(F_CPU / 510 * 64) // Approx. 294.117647 Samples per Seconds
-#define THRESHOLD 5 // 255 Divided by 5 = 51 Steps
+#define THRESHOLD 5 // ADC Value under Threshold Turns Off Output
+#define HYSTERESIS 2 // Minimum Change of ADC Value to Update Brightness, 255 Divided by 2 = 127 Steps
+#define DITHER_BITS 2 // Bits of Fraction for Dithering, 0 to 8
+#define DITHER_MASK (uint8_t)(0xFF00 >> DITHER_BITS)
+#define DITHER_STEP (0x100 >> DITHER_BITS) // Minimum Brightness on Output, Not to Be Zero by DITHER_MASK
 
 /* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
 
 uint8_t osccal_default; // Calibrated Default Value of OSCCAL
+volatile uint8_t dimmer_duty_1;
+volatile uint8_t dimmer_fraction_1;
+volatile uint8_t dimmer_sigma_1; // Accumulator of Sigma-delta
+volatile uint8_t dimmer_duty_2;
+volatile uint8_t dimmer_fraction_2;
+volatile uint8_t dimmer_sigma_2; // Accumulator of Sigma-delta
+
+// Gamma 2.2, (Index / 64)^2.2 * 0xFF00, Index Is ADC[9:2] Scaled to 0-256 and Divided by 4
+uint16_t const dimmer_gamma_array[65] PROGMEM = { // Array in Program Space
+	0x0000,0x0007,0x0020,0x004E,0x0092,0x00EF,0x0165,0x01F6,
+	0x02A1,0x0368,0x044B,0x054C,0x066A,0x07A6,0x0901,0x0A7B,
+	0x0C14,0x0DCD,0x0FA7,0x11A1,0x13BC,0x15F8,0x1856,0x1AD6,
+	0x1D79,0x203E,0x2326,0x2631,0x295F,0x2CB1,0x3027,0x33C1,
+	0x377F,0x3B62,0x3F6A,0x4397,0x47EA,0x4C62,0x50FF,0x55C3,
+	0x5AAC,0x5FBC,0x64F2,0x6A4F,0x6FD3,0x757E,0x7B50,0x814A,
+	0x876B,0x8DB4,0x9424,0x9ABD,0xA17E,0xA867,0xAF79,0xB6B4,
+	0xBE17,0xC5A3,0xCD59,0xD537,0xDD3F,0xE571,0xEDCC,0xF651,
+	0xFF00
+};
+
+/**
+ * Interpolate Bit[1:0] of Scaled ADC Value between Entries of Gamma Table
+ * ADC value is scaled from 0-255 to 0-256 to have the last entry (0xFF00, full power) at 255.
+ * The result is DITHER_STEP at least, because the output is on if ADC value is THRESHOLD or more.
+ */
+static inline uint16_t dimmer_gamma( uint8_t value ) {
+	uint16_t scaled = value + (value >> 7); // Approx. value * 256 / 255
+	uint16_t gamma = pgm_read_word(&(dimmer_gamma_array[scaled >> 2]));
+	uint16_t difference;
+	if ( scaled & 0b11 ) { // Not the Last Entry
+		difference = pgm_read_word(&(dimmer_gamma_array[(scaled >> 2) + 1])) - gamma;
+		if ( scaled & 0b10 ) gamma += difference >> 1;
+		if ( scaled & 0b01 ) gamma += difference >> 2;
+	}
+	if ( gamma < DITHER_STEP ) gamma = DITHER_STEP;
+	return gamma;
+}
 
 int main(void) {
 
@@ -53,10 +100,17 @@ int main(void) {
 	uint8_t const output_clear_2 = ~(_BV(PB1)); // PB1 (OC0B) Low
 	uint8_t const output_start_2 = _BV(DDB1); // Bit Value Set PB1 (OC0B) as Output
 	uint8_t const output_stop_2 = ~(_BV(DDB1)); // Bit Value Clear PB1(OC0B)
+	uint16_t brightness; // 8.8 Fixed Point
 
 	/* Initialize Global Variables */
 
 	osccal_default = OSCCAL;
+	dimmer_duty_1 = 0;
+	dimmer_fraction_1 = 0;
+	dimmer_sigma_1 = 0;
+	dimmer_duty_2 = 0;
+	dimmer_fraction_2 = 0;
+	dimmer_sigma_2 = 0;
 
 	/* Clock Calibration */
 
@@ -94,9 +148,14 @@ int main(void) {
 	// PWM (Phase Correct) Mode (5) can make variable frequencies with adjustable duty cycle by settting OCR0A as TOP, but OC0B is only available.
 	TCCR0A = _BV(WGM00);
 
+	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIM0_OVF_vect)" to Dither
+	TIMSK0 = _BV(TOIE0);
+
 	// Start Counter with I/O-Clock 9.6MHz / ( 510 * 64 ) = Approx. 294.117647Hz
 	TCCR0B = _BV(CS00)|_BV(CS01);
 
+	sei(); // Start to Issue Interrupt
+
 	while(1) {
 		ADMUX |= select_adc_channel_1;
 		ADCSRA |= start_adc;
@@ -112,24 +171,28 @@ int main(void) {
 				PORTB &= output_clear_1;
 				// Bit Value Clear PB0 (OC0A), High-Z State
 				DDRB &= output_stop_1;
-				// Clear Output Compare A
-				OCR0A = 0;
+				// Clear Brightness
+				cli(); // Stop to Issue Interrupt
+				dimmer_duty_1 = 0;
+				dimmer_fraction_1 = 0;
+				sei(); // Start to Issue Interrupt
 				// Clear Stepping Value of ADC Channel 1
 				value_adc_channel_1_high = 0;
 			}
-		} else if ( abs( (int16_t)(value_adc_channel_1_high_buffer - value_adc_channel_1_high) ) >= THRESHOLD ) {
+		} else if ( abs( (int16_t)(value_adc_channel_1_high_buffer - value_adc_channel_1_high) ) >= HYSTERESIS ) {
 			value_adc_channel_1_high = value_adc_channel_1_high_buffer;
+			brightness = dimmer_gamma( value_adc_channel_1_high );
+			// Set Brightness, Output Compare A Is Set in Overflow Interrupt
+			cli(); // Stop to Issue Interrupt
+			dimmer_duty_1 = brightness >> 8;
+			dimmer_fraction_1 = brightness & DITHER_MASK;
+			sei(); // Start to Issue Interrupt
 			// Start Output
 			if ( ! ( DDRB & output_start_1 ) ) {
 				// PWM Output 1 Start
 				TCCR0A |= pwm_output_a_start;
 				// Bit Value Set PB0 (OC0A) as Output
 				DDRB |= output_start_1;
-				// Set Output Compare A
-				OCR0A = value_adc_channel_1_high;
-			} else {
-				// Set Output Compare A
-				OCR0A = value_adc_channel_1_high;
 			}
 		}
 
@@ -147,24 +210,28 @@ int main(void) {
 				PORTB &= output_clear_2;
 				// Bit Value Clear PB1 (OC0B), High-Z State
 				DDRB &= output_stop_2;
-				// Clear Output Compare B
-				OCR0B = 0;
+				// Clear Brightness
+				cli(); // Stop to Issue Interrupt
+				dimmer_duty_2 = 0;
+				dimmer_fraction_2 = 0;
+				sei(); // Start to Issue Interrupt
 				// Clear Stepping Value of ADC Channel 2
 				value_adc_channel_2_high = 0;
 			}
-		} else if ( abs( (int16_t)(value_adc_channel_2_high_buffer - value_adc_channel_2_high) ) >= THRESHOLD ) {
+		} else if ( abs( (int16_t)(value_adc_channel_2_high_buffer - value_adc_channel_2_high) ) >= HYSTERESIS ) {
 			value_adc_channel_2_high = value_adc_channel_2_high_buffer;
+			brightness = dimmer_gamma( value_adc_channel_2_high );
+			// Set Brightness, Output Compare B Is Set in Overflow Interrupt
+			cli(); // Stop to Issue Interrupt
+			dimmer_duty_2 = brightness >> 8;
+			dimmer_fraction_2 = brightness & DITHER_MASK;
+			sei(); // Start to Issue Interrupt
 			// Start Output
 			if ( ! ( DDRB & output_start_2 ) ) {
 				// PWM Output 2 Start
 				TCCR0A |= pwm_output_b_start;
 				// Bit Value Set PB1 (OC0B) as Output
 				DDRB |= output_start_2;
-				// Set Output Compare B
-				OCR0B = value_adc_channel_2_high;
-			} else {
-				// Set Output Compare B
-				OCR0B = value_adc_channel_2_high;
 			}
 		}
 
@@ -172,3 +239,17 @@ int main(void) {
 	}
 	return 0;
 }
+
+/**
+ * Overflow occurs at BOTTOM in PWM (Phase Correct) Mode, and Output Compare Registers are updated at TOP.
+ * Duty + 1 never overflows, because the fraction is zero at the maximum duty (0xFF00).
+ */
+ISR(TIM0_OVF_vect) {
+	uint16_t sigma;
+	sigma = dimmer_sigma_1 + dimmer_fraction_1;
+	dimmer_sigma_1 = sigma;
+	OCR0A = dimmer_duty_1 + (sigma >> 8);
+	sigma = dimmer_sigma_2 + dimmer_fraction_2;
+	dimmer_sigma_2 = sigma;
+	OCR0B = dimmer_duty_2 + (sigma >> 8);
+}
@@ -16,10 +16,17 @@
 #include <util/delay.h>
 #include <util/delay_basic.h>
 
+#define SOFTWARE_UART_TIMER // Software UART Tx Driven by Timer0
+#define SOFTWARE_UART_PIN_TX PB4
+#define SOFTWARE_UART_BAUD_RATE 4800
+#include "include_13/software_uart.h"
+#include "include/pwm_dual.h"
+
 #define CALIB_OSCCAL 0x03 // Frequency Calibration for Individual Difference at VCC = 3.3V
 
 /**
  * Output Sawtooth Wave from PB0 (OC0A)
+ * Output Low Byte of Sawtooth Wave from PB1 (OC0B) If OUTPUT_DUAL_PWM Is 1 (See include/pwm_dual.h)
  * Input from PB2 (Bit[0]), Set by Detecting Low
  * Input from PB3 (Bit[1]), Set by Detecting Low
  * Bit[1:0]:
@@ -27,6 +34,9 @@
  *     0b01: Play Sequence No.1
  *     0b10: Play Sequence No.2
  *     0b11: PLay Sequence No.3
+ * Software UART Tx from PB4 (4800 baud): Send the value of the sequence (Bit[7:0]) at each step.
+ * If OUTPUT_ENVELOPE is 1, the wave is multiplied by the ADSR envelope of the sequence, and rests release the last note.
+ *     The multiply without MUL takes approx. 60 clocks of 256 clocks per sample, and the envelope is updated in the main loop.
  * Note: The wave may not reach the high peak, 0xFF (255) in default,
  *       because of its low precision decimal system.
  *       Tuning of OSCCAL changes the frequency of the clock, affecting interval of the sequence.
@@ -39,6 +49,28 @@
 #define SEQUENCER_INTERVAL 4687 // Approx. 8Hz = 0.125 Seconds
 #define SEQUENCER_COUNTUPTO 64 // 0.125 Seconds * 64
 #define SEQUENCER_SEQUENCENUMBER 3 // Maximum Number of Sequence
+#define OUTPUT_DUAL_PWM 0 // 0 = 8-bit Output from OC0A, 1 = 15-bit Output from OC0A (High Byte) and OC0B (Low Byte)
+
+#if OUTPUT_DUAL_PWM
+#define OUTPUT_PEAK_LOW() pwm_dual_set( PEAK_LOW << 8 )
+#else
+#define OUTPUT_PEAK_LOW() (OCR0A = PEAK_LOW)
+#endif
+
+#define OUTPUT_ENVELOPE 0 // 0 = Notes Start and Stop Abruptly, 1 = ADSR Envelope at Approx. 1kHz (See include/envelope.h)
+#if OUTPUT_ENVELOPE
+#include "include/fixed_math.h"
+#define ENVELOPE_SAMPLE_RATE (F_CPU / 256)
+#include "include/envelope.h"
+#if PEAK_LOW
+#error "OUTPUT_ENVELOPE needs PEAK_LOW of 0x00 to multiply the wave."
+#endif
+#define OUTPUT_GAIN(value) fixed_math_mul_u8( value, envelope_level[0] )
+#define OUTPUT_GAIN_16(value) fixed_math_mul_u8_u16( (value) >> 8, envelope_level[0] ) // Low Byte Is Made by Multiply
+#else
+#define OUTPUT_GAIN(value) (value)
+#define OUTPUT_GAIN_16(value) (value)
+#endif
 
 /* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
 
@@ -83,6 +115,18 @@ uint8_t const sequencer_array[SEQUENCER_SEQUENCENUMBER][SEQUENCER_COUNTUPTO] PRO
 	 239,240,241,242,243,244,245,246,247,246,245,244,243,242,241,240}  // Sequence No.3
 };
 
+#if OUTPUT_ENVELOPE
+/**
+ * ADSR Envelope of Each Sequence: Attack, Decay, Sustain, Release
+ * Attack, decay, and release are indexes of envelope_rate_array, and sustain is the level (See include/envelope.h).
+ */
+uint8_t const sequencer_envelope_array[SEQUENCER_SEQUENCENUMBER][ENVELOPE_PARAMETER_NUMBER] PROGMEM = { // Array in Program Space
+	{  2, 11, 0xA0,  8}, // Sequence No.1: Attack 2ms, Decay 43ms to 63%, Release 16ms
+	{  4, 12, 0xC0, 10}, // Sequence No.2: Attack 4ms, Decay 64ms to 75%, Release 32ms
+	{  6, 14, 0xFF, 12}  // Sequence No.3: Attack 8ms, No Decay, Release 64ms
+};
+#endif
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -96,6 +140,9 @@ int main(void) {
 	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
 	int8_t osccal_tuning = 0; // Tuning Value for Variable Tone
 	int8_t osccal_pitch = 0; // Pitch Value
+#if OUTPUT_ENVELOPE
+	uint8_t is_note_on = 0;
+#endif
 
 	/* Initialize Global Variables */
 
@@ -105,6 +152,9 @@ int main(void) {
 	sequencer_interval_count = 0;
 	sequencer_count_update = 0;
 	sequencer_count_last = 0;
+#if OUTPUT_ENVELOPE
+	envelope_init();
+#endif
 
 	/* Clock Calibration */
 
@@ -113,23 +163,42 @@ int main(void) {
 
 	/* I/O Settings */
 
-	DIDR0 = _BV(PB5)|_BV(PB4)|_BV(PB1)|_BV(PB0); // Digital Input Disable
+	DIDR0 = _BV(PB5)|_BV(PB1)|_BV(PB0); // Digital Input Disable
 	PORTB = _BV(PB3)|_BV(PB2); // Pullup Button Input (There is No Internal Pulldown)
+#if OUTPUT_DUAL_PWM
+	DDRB = _BV(DDB1)|_BV(DDB0); // Bit Value Set PB1 (OC0B) and PB0 (OC0A)
+#else
 	DDRB = _BV(DDB0); // Bit Value Set PB0 (OC0A)
+#endif
+	software_uart_init(); // Software UART Tx (PB4) High
 
 	/* Counter/Timer */
 
 	// Counter Reset
 	TCNT0 = 0;
 
+#if OUTPUT_DUAL_PWM
+	// Set Output Compare A and B
+	pwm_dual_set( PEAK_LOW << 8 );
+
+	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIM0_OVF_vect)", Software UART Tx Is Also Handled
+	TIMSK0 = _BV(TOIE0);
+
+	// Select Fast PWM Mode (3) and Output from OC0A and OC0B Non-inverted
+	TCCR0A = _BV(WGM01)|_BV(WGM00)|_BV(COM0B1)|_BV(COM0A1);
+#else
 	// Set Output Compare A
 	OCR0A = PEAK_LOW;
 
-	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIM0_OVF_vect)"
-	TIMSK0 = _BV(TOIE0);
+	// Set Output Compare B at Middle of Period for Software UART Tx, OC0B Is Disconnected
+	OCR0B = 0x80;
+
+	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIM0_OVF_vect)" and Compare Match B Interrupt for "ISR(TIM0_COMPB_vect)"
+	TIMSK0 = _BV(OCIE0B)|_BV(TOIE0);
 
 	// Select Fast PWM Mode (3) and Output from OC0A Non-inverted
 	TCCR0A = _BV(WGM01)|_BV(WGM00)|_BV(COM0A1);
+#endif
 
 	// Start Counter with I/O-Clock 9.6MHz / ( 1 * 256 ) = 37500Hz
 	TCCR0B = _BV(CS00);
@@ -138,6 +207,9 @@ int main(void) {
 	sei();
 
 	while(1) {
+#if OUTPUT_ENVELOPE
+		if ( envelope_is_update ) envelope_update();
+#endif
 		input_pin = 0;
 		if ( ! (PINB & pin_button1) ) {
 			input_pin |= 0b01;
@@ -152,6 +224,10 @@ int main(void) {
 				if ( ! sequencer_count_start ) sequencer_count_start = 1;
 				if ( input_pin >= SEQUENCER_SEQUENCENUMBER ) input_pin = SEQUENCER_SEQUENCENUMBER;
 				sequencer_value = pgm_read_byte(&(sequencer_array[input_pin - 1][sequencer_count_last]));
+				if ( ! software_uart_tx_count ) { // If Software UART Tx Is Idle
+					software_uart_tx_byte = sequencer_value;
+					software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+				}
 				/* Heptatonic Scale, G4 to C6, 37500 Samples per Seconds */
 				if ( sequencer_value == 11 ) {
 					count_per_2pi_buffer = 35; // C6 1046.50 Hz
@@ -204,6 +280,21 @@ int main(void) {
 					fixed_delta_sawtooth_buffer = 0;
 					osccal_tuning = 0;
 				}
+#if OUTPUT_ENVELOPE
+				if ( ! count_per_2pi_buffer ) { // Rest
+					envelope_note_off( 0 ); // Wave Keeps Running until Release Ends
+					is_note_on = 0;
+				} else if ( count_per_2pi_buffer != count_per_2pi || ! is_note_on ) {
+					cli(); // Stop to Issue Interrupt
+					sample_count = 0;
+					count_per_2pi = count_per_2pi_buffer;
+					fixed_delta_sawtooth = fixed_delta_sawtooth_buffer;
+					function_start = 1;
+					sei(); // Start to Issue Interrupt
+					envelope_note_on( 0, sequencer_envelope_array[input_pin - 1] );
+					is_note_on = 1;
+				}
+#else
 				if ( count_per_2pi_buffer != count_per_2pi ) {
 					if ( count_per_2pi_buffer ) {
 						cli(); // Stop to Issue Interrupt
@@ -216,10 +307,11 @@ int main(void) {
 						cli(); // Stop to Issue Interrupt
 						count_per_2pi = 0;
 						function_start = 0;
-						OCR0A = PEAK_LOW;
+						OUTPUT_PEAK_LOW();
 						sei(); // Start to Issue Interrupt
 					}
 				}
+#endif
 				OSCCAL = osccal_default + osccal_tuning + osccal_pitch;
 			}
 		} else {
@@ -231,7 +323,11 @@ int main(void) {
 				sequencer_interval_count = 0;
 				sequencer_count_update = 0;
 				sequencer_count_last = 0;
-				OCR0A = PEAK_LOW;
+				OUTPUT_PEAK_LOW();
+#if OUTPUT_ENVELOPE
+				envelope_init();
+				is_note_on = 0;
+#endif
 				sei();
 			}
 		}
@@ -240,22 +336,31 @@ int main(void) {
 }
 
 ISR(TIM0_OVF_vect) {
+#if ! OUTPUT_DUAL_PWM
 	uint16_t temp;
+#endif
 
 	if ( function_start ) { // Start Function
 		// Saw Tooth Wave
 		if ( sample_count == 0 ) {
-			OCR0A = PEAK_LOW;
+			OUTPUT_PEAK_LOW();
 			fixed_value_sawtooth = PEAK_LOW << 7;
 		} else if ( sample_count <= count_per_2pi ) {
 			fixed_value_sawtooth += fixed_delta_sawtooth; // Fixed Point Arithmetic (ADD)
+#if OUTPUT_DUAL_PWM
+			pwm_dual_set( OUTPUT_GAIN_16( fixed_value_sawtooth << 1 ) ); // Bit[15:8] UINT8 and Bit[7:1] Fractional Part, No Round Off
+#else
 			temp = (fixed_value_sawtooth << 1) >> 8; // Make Bit[7:0] UINT8 (Considered of Clock Cycle)
 			if ( 0x0040 & fixed_value_sawtooth ) temp++; // Check Fractional Part Bit[6] (0.5) to Round Off
-			OCR0A = temp;
+			OCR0A = OUTPUT_GAIN( temp );
+#endif
 		}
 		sample_count++;
 		if ( sample_count > count_per_2pi ) sample_count = 0;
 	}
+#if OUTPUT_ENVELOPE
+	envelope_handler_sample();
+#endif
 	if ( sequencer_count_start ) { // If Not Zero, Sequencer Is Outstanding
 		sequencer_interval_count++;
 		if ( sequencer_interval_count >= SEQUENCER_INTERVAL ) {
@@ -263,4 +368,13 @@ ISR(TIM0_OVF_vect) {
 			sequencer_count_update++;
 		}
 	}
+#if OUTPUT_DUAL_PWM
+	software_uart_handler_tx();
+#endif
+}
+
+#if ! OUTPUT_DUAL_PWM
+ISR(TIM0_COMPB_vect) {
+	software_uart_handler_tx();
 }
+#endif
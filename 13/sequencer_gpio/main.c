@@ -126,22 +126,8 @@ int main(void) {
 				}
 				if ( input_pin >= SEQUENCER_SEQUENCENUMBER ) input_pin = SEQUENCER_SEQUENCENUMBER;
 				sequencer_value = pgm_read_byte(&(sequencer_array[input_pin - 1][sequencer_count_last]));
-				sequencer_output = PORTB;
-				if ( sequencer_value & _BV(PB0) ) {
-					sequencer_output |= _BV(PB0);
-				} else {
-					sequencer_output &= ~(_BV(PB0));
-				}
-				if ( sequencer_value & _BV(PB1) ) {
-					sequencer_output |= _BV(PB1);
-				} else {
-					sequencer_output &= ~(_BV(PB1));
-				}
-				if ( sequencer_value & _BV(PB2) ) {
-					sequencer_output |= _BV(PB2);
-				} else {
-					sequencer_output &= ~(_BV(PB2));
-				}
+				// Bit[2:0] Is Mapped to PB2-PB0 as Is, and PB4 and PB3 Keep Pull-up, Single Write without Glitch between Pins
+				sequencer_output = (sequencer_value & (_BV(PB2)|_BV(PB1)|_BV(PB0)))|_BV(PB4)|_BV(PB3);
 				PORTB = sequencer_output;
 			}
 		} else {
@@ -151,9 +137,7 @@ int main(void) {
 				sequencer_interval_count = 0;
 				sequencer_count_update = 0;
 				sequencer_count_last = 0;
-				sequencer_output = PORTB;
-				sequencer_output &= ~(_BV(PB2)|_BV(PB1)|_BV(PB0));
-				PORTB = sequencer_output;
+				PORTB = _BV(PB4)|_BV(PB3); // Outputs Low and Pull-up Button Inputs
 			}
 		}
 	}
@@ -31,6 +31,9 @@
  *     0b011: PLay Sequence No.3
  *     0b100: PLay Sequence No.4
  *     ...
+ * Note: If the bit of a step in sequencer_fade_array is set, the pulse width fades linearly from the value of the step to the value of the next step.
+ *       The increment in 8.7 fixed point is calculated once per step in main, and the overflow interrupt only adds the increment at 294Hz.
+ *       The value is reset to the exact value at the start of each step, so the error of the increment doesn't accumulate.
  */
 
 #define SAMPLE_RATE (double)(F_CPU / 510 * 64) // Approx. 294.117647 Samples per Seconds
@@ -43,6 +46,10 @@
 uint8_t sequencer_count_start;
 uint16_t sequencer_interval_count;
 uint16_t sequencer_count_update;
+volatile uint16_t sequencer_value_a; // 8.7 Fixed Point
+volatile int16_t sequencer_delta_a; // 8.7 Fixed Point
+volatile uint16_t sequencer_value_b; // 8.7 Fixed Point
+volatile int16_t sequencer_delta_b; // 8.7 Fixed Point
 
 /**
  * Sequences for OC0A
@@ -90,6 +97,22 @@ uint8_t const sequencer_array_b[SEQUENCER_SEQUENCENUMBER][SEQUENCER_COUNTUPTO] P
 	  10, 30, 30, 40, 50, 60, 70, 80, 90,100,110,120,130,140,150,160}  // Sequence No.4
 };
 
+/**
+ * Fading of Steps
+ * Bit[n] of Byte[i]: Step No.(i * 8 + n), 0 = Hold Value, 1 = Fade to Next Value
+ */
+uint8_t const sequencer_fade_array[SEQUENCER_SEQUENCENUMBER][SEQUENCER_COUNTUPTO / 8] PROGMEM = { // Array in Program Space
+	{0xFF,0x7F,0x00,0x00,0x00,0x00,0x00,0x00}, // Sequence No.1
+	{0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF}, // Sequence No.2
+	{0xFE,0xFF,0xFF,0x7F,0xFE,0xFF,0xFF,0x7F}, // Sequence No.3
+	{0xFF,0xFF,0xFF,0x01,0x00,0x00,0x00,0x00}  // Sequence No.4
+};
+
+// Increment in 8.7 Fixed Point to Reach Next Value in SEQUENCER_INTERVAL, Truncated toward Zero Not to Exceed Next Value
+static inline int16_t sequencer_delta( uint8_t value, uint8_t value_next ) {
+	return (((int16_t)value_next - (int16_t)value) * 128) / SEQUENCER_INTERVAL;
+}
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -98,6 +121,11 @@ int main(void) {
 	uint8_t const pin_button3 = _BV(PINB4); // Assign PB4 as Button Input
 	uint16_t sequencer_count_last = 0;
 	uint8_t input_pin;
+	uint8_t sequencer_count_next;
+	uint8_t value_a;
+	uint8_t value_b;
+	int16_t delta_a;
+	int16_t delta_b;
 	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
 
 	/* Initialize Global Variables */
@@ -160,8 +188,24 @@ int main(void) {
 					sei(); // Start to Issue Interrupt
 				}
 				if ( input_pin >= SEQUENCER_SEQUENCENUMBER ) input_pin = SEQUENCER_SEQUENCENUMBER;
-				OCR0A = pgm_read_byte(&(sequencer_array_a[input_pin - 1][sequencer_count_last]));
-				OCR0B = pgm_read_byte(&(sequencer_array_b[input_pin - 1][sequencer_count_last]));
+				value_a = pgm_read_byte(&(sequencer_array_a[input_pin - 1][sequencer_count_last]));
+				value_b = pgm_read_byte(&(sequencer_array_b[input_pin - 1][sequencer_count_last]));
+				delta_a = 0;
+				delta_b = 0;
+				if ( pgm_read_byte(&(sequencer_fade_array[input_pin - 1][sequencer_count_last >> 3])) & _BV(sequencer_count_last & 0x7) ) {
+					sequencer_count_next = sequencer_count_last + 1;
+					if ( sequencer_count_next >= SEQUENCER_COUNTUPTO ) sequencer_count_next = 0;
+					delta_a = sequencer_delta( value_a, pgm_read_byte(&(sequencer_array_a[input_pin - 1][sequencer_count_next])) );
+					delta_b = sequencer_delta( value_b, pgm_read_byte(&(sequencer_array_b[input_pin - 1][sequencer_count_next])) );
+				}
+				cli(); // Stop to Issue Interrupt
+				sequencer_value_a = (uint16_t)value_a << 7;
+				sequencer_delta_a = delta_a;
+				sequencer_value_b = (uint16_t)value_b << 7;
+				sequencer_delta_b = delta_b;
+				sei(); // Start to Issue Interrupt
+				OCR0A = value_a;
+				OCR0B = value_b;
 			}
 		} else {
 			if ( SREG & _BV(SREG_I) ) { // If Global Interrupt Enable Flag Is Set
@@ -180,6 +224,11 @@ int main(void) {
 
 ISR(TIM0_OVF_vect) {
 	if ( sequencer_count_start ) { // If Not Zero, Sequencer Is Outstanding
+		// Fade, No Division
+		sequencer_value_a += sequencer_delta_a;
+		sequencer_value_b += sequencer_delta_b;
+		OCR0A = sequencer_value_a >> 7;
+		OCR0B = sequencer_value_b >> 7;
 		sequencer_interval_count++;
 		if ( sequencer_interval_count >= SEQUENCER_INTERVAL ) {
 			sequencer_interval_count = 0;
@@ -0,0 +1,124 @@
+/**
+ * main.c
+ *
+ * Author: Kenta Ishii
+ * License: 3-Clause BSD License
+ * License URL: https://opensource.org/licenses/BSD-3-Clause
+ *
+ */
+
+#define F_CPU 9600000UL // Default 9.6Mhz to ATtiny13
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+#include <util/delay_basic.h>
+
+#define CALIB_OSCCAL 0x03 // Frequency Calibration for Individual Difference at VCC = 3.3V
+
+/**
+ * Software PWM Output Red from PB0
+ * Software PWM Output Green from PB1
+ * Software PWM Output Blue from PB2
+ * Software PWM Output White from PB4
+ * Input from PB3, Play Sequence by Detecting Low
+ * Note: PWM frequency is 585.9375Hz. See include_13/software_pwm.h.
+ */
+
+#define SOFTWARE_PWM_CHANNELS 4
+#define SOFTWARE_PWM_PINS {_BV(PB0),_BV(PB1),_BV(PB2),_BV(PB4)}
+#include "include_13/software_pwm.h"
+
+#define SAMPLE_RATE (double)(F_CPU / (256 * 64)) // 585.9375 Samples per Seconds
+#define SEQUENCER_INTERVAL 147 // Approx. 4Hz = 0.25 Seconds
+#define SEQUENCER_COUNTUPTO 32 // 0.25 Seconds * 32
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+volatile uint8_t sequencer_count_start;
+volatile uint8_t sequencer_interval_count;
+volatile uint8_t sequencer_count_update;
+
+/**
+ * Sequence for RGBW
+ * {Red, Green, Blue, White}, 0 = Off, 255 = Always On
+ */
+uint8_t const sequencer_array[SEQUENCER_COUNTUPTO][SOFTWARE_PWM_CHANNELS] PROGMEM = { // Array in Program Space
+	{0xFE,0x00,0x00,0x00},{0xFE,0x40,0x00,0x00},{0xFE,0x7F,0x00,0x00},{0xFE,0xBE,0x00,0x00},
+	{0xFE,0xFE,0x00,0x00},{0xBE,0xFE,0x00,0x00},{0x7F,0xFE,0x00,0x00},{0x40,0xFE,0x00,0x00},
+	{0x00,0xFE,0x00,0x00},{0x00,0xFE,0x40,0x00},{0x00,0xFE,0x7F,0x00},{0x00,0xFE,0xBE,0x00},
+	{0x00,0xFE,0xFE,0x00},{0x00,0xBE,0xFE,0x00},{0x00,0x7F,0xFE,0x00},{0x00,0x40,0xFE,0x00},
+	{0x00,0x00,0xFE,0x00},{0x40,0x00,0xFE,0x00},{0x7F,0x00,0xFE,0x00},{0xBE,0x00,0xFE,0x00},
+	{0xFE,0x00,0xFE,0x00},{0xFE,0x00,0xBE,0x00},{0xFE,0x00,0x7F,0x00},{0xFE,0x00,0x40,0x00},
+	{0x00,0x00,0x00,0x10},{0x00,0x00,0x00,0x40},{0x00,0x00,0x00,0x80},{0x00,0x00,0x00,0xFF},
+	{0x00,0x00,0x00,0xFF},{0x00,0x00,0x00,0x80},{0x00,0x00,0x00,0x40},{0x00,0x00,0x00,0x10}
+};
+
+int main(void) {
+
+	/* Declare and Define Local Constants and Variables */
+	uint8_t const pin_button1 = _BV(PINB3); // Assign PB3 as Button Input
+	uint8_t sequencer_count_last = 0;
+	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
+
+	/* Initialize Global Variables */
+
+	sequencer_count_start = 0;
+	sequencer_interval_count = 0;
+	sequencer_count_update = 0;
+
+	/* Clock Calibration */
+
+	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
+	OSCCAL = osccal_default;
+
+	/* I/O Settings */
+
+	DIDR0 = _BV(PB5)|_BV(PB4)|_BV(PB2)|_BV(PB1)|_BV(PB0); // Digital Input Disable
+	PORTB = _BV(PB3); // Pullup Button Input (There is No Internal Pulldown)
+
+	/* Counter/Timer */
+
+	software_pwm_init(); // Set Outputs, Start Timer/Counter0
+
+	sei(); // Start to Issue Interrupt
+
+	while(1) {
+		if ( ! (PINB & pin_button1) ) {
+			if ( ! sequencer_count_start || sequencer_count_update != sequencer_count_last ) {
+				if ( ! sequencer_count_start ) {
+					sequencer_interval_count = 0;
+					sequencer_count_update = 0;
+					sequencer_count_start = 1;
+				}
+				if ( sequencer_count_update >= SEQUENCER_COUNTUPTO ) sequencer_count_update = 0;
+				sequencer_count_last = sequencer_count_update;
+				for ( uint8_t i = 0; i < SOFTWARE_PWM_CHANNELS; i++ ) {
+					software_pwm_duty[i] = pgm_read_byte(&(sequencer_array[sequencer_count_last][i]));
+				}
+				software_pwm_update();
+			}
+		} else if ( sequencer_count_start ) {
+			sequencer_count_start = 0;
+			for ( uint8_t i = 0; i < SOFTWARE_PWM_CHANNELS; i++ ) software_pwm_duty[i] = 0;
+			software_pwm_update();
+		}
+	}
+	return 0;
+}
+
+ISR(TIM0_OVF_vect) {
+	software_pwm_handler_overflow();
+	if ( sequencer_count_start ) { // If Not Zero, Sequencer Is Outstanding
+		if ( ++sequencer_interval_count >= SEQUENCER_INTERVAL ) {
+			sequencer_interval_count = 0;
+			sequencer_count_update++;
+		}
+	}
+}
+
+ISR(TIM0_COMPA_vect) {
+	software_pwm_handler_compare();
+}
@@ -0,0 +1,261 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+#define F_CPU 16000000UL // PLL 16.0Mhz to ATtiny85
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <util/delay_basic.h>
+
+#ifndef CALIB_OSCCAL
+#define CALIB_OSCCAL 0x00
+#warning "CALIB_OSCCAL is defined with the default value 0x00."
+#endif
+
+/**
+ * Port of 13/amplifier to ATtiny85 as a Class-D Amplifier
+ * Output from PB1 (OC1A) and PB0 (!OC1A), Complementary with Dead Time
+ * Input from PB2 Gain (Bit[0]), Set by Detecting Low
+ * Input from PB3 Gain (Bit[1]), Set by Detecting Low
+ * Gain Bit[1:0]:
+ *     0b00: Gain 0dB (Voltage), Multiplier 0
+ *     0b01: Gain Approx. 6dB, Multiplier 2
+ *     0b10: Gain Approx. 12dB, Multiplier 4
+ *     0b11: Gain Approx. 18dB, Multiplier 8
+ * Input from PB4 (ADC2)
+ * Note1: The reference voltage of ADC is VCC.
+ *        Gain approx. 12dB (Multiplier 4) is added to the value determined by Gain Bit[1:0].
+ * Note2: Timer/Counter1 makes PWM with PLL Clock 64.0MHz / 256 (OCR1C + 1) = 250kHz, and Timer/Counter0 makes the sampling rate.
+ *        ADC clock rate is set at 1M Hz to have more speed than sampling rate.
+ *        One sampling takes (1 / 1M) * 13 = 13 microseconds in ADC.
+ *        Whereas, the sampling rate is approx. 37735.85 samples per second, which takes 1 / 37735.85 = 26.5 microseconds.
+ * Note3: Connect a speaker between PB1 and PB0 through LC filters (bridge-tied load).
+ *        The voltage across the speaker swings from -VCC to +VCC, the double of single-ended output from 0V to VCC with a DC cut capacitor.
+ *        PWM_BIAS makes 50% duty cycle, i.e., 0V across the speaker with no input.
+ * Note4: The dead time generator delays the rising edge of each output, so OC1A and !OC1A are never high at the same time.
+ *        If PB1 and PB0 drive the high side and the low side of a MOSFET half bridge through gate drivers, the dead time prevents shoot-through current.
+ *        The dead time is DEAD_TIME_COUNT / (64.0MHz / DEAD_TIME_PRESCALER), and it must be longer than the turn-off time of MOSFETs.
+ *        The duty cycle is reduced by the dead time at both ends, so the clipping of PWM_CLIP_UPPER and PWM_CLIP_UNDER should cover it.
+ * Note5: The bias value for ADC is 512 in default. See Note4 to Note7 in 13/amplifier/main.c about DC offset, bias voltage, and noise.
+ *
+ * If INPUT_DIFFERENTIAL is 1, the input is the difference of PB4 (ADC2, Positive) and PB3 (ADC3, Negative) in bipolar mode.
+ * Input from PB2 Gain (Bit[0]), Set by Detecting Low
+ * Gain Bit[0]:
+ *     0b0: Gain 0dB of ADC (1x)
+ *     0b1: Gain Approx. 26dB of ADC (20x)
+ * Note6: The gain of ADC is applied before quantization, so the noise of quantization isn't amplified unlike left shifts.
+ *        A result of ADC is -512 to 511, (Positive - Negative) * 512 * Gain / VCC. Gain approx. 12dB (Multiplier 4) is added as single-ended.
+ *        Connect the both ends of an ECM (or a balanced line) with the same DC bias, e.g., VCC / 2 through resistors, the common noise is cancelled.
+ * Note7: The offset of each gain is measured with ADC2 to ADC2 at the start, and subtracted from samples instead of ADC_BIAS_CORRECTION.
+ *        The first conversion after changing the gain is not accurate, but it's only a sample.
+ */
+
+#define INPUT_DIFFERENTIAL 0 // 0 = Single-ended ADC2 with Gain Bit[1:0], 1 = Differential ADC2 - ADC3 with Gain Bit[0] of ADC
+
+#define SAMPLE_RATE (double)(F_CPU / 8 / 53) // Approx. 37735.85 Samples per Second
+#define INPUT_SENSITIVITY 250 // Less Number, More Sensitive (Except 0: Lowest Sensitivity)
+#define ADC_BIAS_DEFAULT 512 // 10-bit Unsigned
+#define ADC_BIAS_CORRECTION -3 // Correction of DC Bias at ADC
+#define ADC_CLIP 112 // 8-bit Unsigned
+#define PWM_BIAS 128 // 8-bit Unsigned
+#define PWM_CLIP_UPPER PWM_BIAS + ADC_CLIP + ADC_BIAS_CORRECTION // Clip PWM Value over This Value, 8-bit Unsigned
+#define PWM_CLIP_UNDER PWM_BIAS - ADC_CLIP + ADC_BIAS_CORRECTION // Clip PWM Value under This Value, 8-bit Unsigned (No Negative)
+#define DEAD_TIME_PRESCALER 1 // 1, 2, 4, or 8 of PLL Clock (64.0MHz)
+#define DEAD_TIME_COUNT 6 // 1 to 15, 6 / 64.0MHz = Approx. 94 Nanoseconds
+#if DEAD_TIME_PRESCALER == 1
+#define DEAD_TIME_DTPS1 0
+#elif DEAD_TIME_PRESCALER == 2
+#define DEAD_TIME_DTPS1 _BV(DTPS10)
+#elif DEAD_TIME_PRESCALER == 4
+#define DEAD_TIME_DTPS1 _BV(DTPS11)
+#elif DEAD_TIME_PRESCALER == 8
+#define DEAD_TIME_DTPS1 (_BV(DTPS11)|_BV(DTPS10))
+#else
+#error "DEAD_TIME_PRESCALER must be 1, 2, 4, or 8."
+#endif
+
+#define ADMUX_DIFFERENTIAL_1X (_BV(MUX2)|_BV(MUX1)) // ADC2 (Positive), ADC3 (Negative), 1x
+#define ADMUX_DIFFERENTIAL_20X (_BV(MUX2)|_BV(MUX1)|_BV(MUX0)) // ADC2 (Positive), ADC3 (Negative), 20x
+#define ADMUX_OFFSET_1X _BV(MUX2) // ADC2 (Positive), ADC2 (Negative), 1x
+#define ADMUX_OFFSET_20X (_BV(MUX2)|_BV(MUX0)) // ADC2 (Positive), ADC2 (Negative), 20x
+#define ADC_OFFSET_SHIFT 4 // Average of 16 Conversions
+
+_Static_assert( DEAD_TIME_COUNT >= 1 && DEAD_TIME_COUNT <= 15, "DEAD_TIME_COUNT must be 1 to 15." );
+
+typedef union _adc16 {
+	struct _value8 {
+		uint8_t lower; // Bit[7:0] = ADC[7:0]
+		uint8_t upper; // Bit[1:0] = ADC[9:8]
+	} value8;
+	int16_t value16;
+} adc16;
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint16_t input_sensitivity_count;
+uint8_t input_pin_last;
+uint8_t input_pin_buffer;
+#if INPUT_DIFFERENTIAL
+int16_t adc_offset[2]; // Index Is Gain Bit[0]
+
+// Sign Extension of Bipolar Mode, Bit[9] Is Sign
+static inline void adc_sign_extend( adc16* adc_sample ) {
+	if ( adc_sample->value8.upper & 0x02 ) adc_sample->value8.upper |= 0xFC;
+}
+
+// Measure Offset with Same Pin to Positive and Negative, ADC Must Be Enabled without Interrupt
+static inline int16_t adc_offset_measure( uint8_t admux ) {
+	adc16 adc_sample;
+	int16_t sum = 0;
+	ADMUX = admux;
+	for ( uint8_t i = 0; i <= (1 << ADC_OFFSET_SHIFT); i++ ) {
+		ADCSRA |= _BV(ADSC);
+		while ( ADCSRA & _BV(ADSC) );
+		adc_sample.value8.lower = ADCL;
+		adc_sample.value8.upper = ADCH;
+		adc_sign_extend( &adc_sample );
+		if ( i ) sum += adc_sample.value16; // First Conversion after Changing Gain Is Discarded
+	}
+	return sum >> ADC_OFFSET_SHIFT;
+}
+#endif
+
+int main(void) {
+	/* Declare and Define Local Constants and Variables */
+	uint8_t const start_adc = _BV(ADSC);
+	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
+
+	/* Initialize Global Variables */
+	input_sensitivity_count = INPUT_SENSITIVITY;
+	input_pin_last = 0;
+	input_pin_buffer = 0;
+
+	/* Clock Calibration */
+	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
+	OSCCAL = osccal_default;
+
+	/* PLL On */
+	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
+	do {
+		_delay_us(100);
+	} while ( ! (PLLCSR & _BV(PLOCK)) );
+	PLLCSR |= _BV(PCKE);
+
+	/* I/O Settings */
+#if INPUT_DIFFERENTIAL
+	PORTB = _BV(PB2); // Pullup Button Input (There is No Internal Pulldown)
+#else
+	PORTB = _BV(PB3)|_BV(PB2); // Pullup Button Input (There is No Internal Pulldown)
+#endif
+	DDRB = _BV(DDB1)|_BV(DDB0); // Bit Value Set PB1 (OC1A) and PB0 (!OC1A) as Output
+
+	/* ADC */
+#if INPUT_DIFFERENTIAL
+	// For Noise Reduction of ADC, Disable Digital Input Buffers
+	DIDR0 = _BV(ADC3D)|_BV(ADC2D);
+	// Bipolar Mode
+	ADCSRB = _BV(BIN);
+	// ADC Enable, Prescaler 16 to Have ADC Clock 1Mhz
+	ADCSRA = _BV(ADEN)|_BV(ADPS2);
+	adc_offset[0] = adc_offset_measure( ADMUX_OFFSET_1X );
+	adc_offset[1] = adc_offset_measure( ADMUX_OFFSET_20X );
+	// Set ADC, Voltage Reference VCC, ADC2 (PB4) - ADC3 (PB3), 1x
+	ADMUX = ADMUX_DIFFERENTIAL_1X;
+#else
+	// For Noise Reduction of ADC, Disable Digital Input Buffer
+	DIDR0 = _BV(ADC2D);
+	// Set ADC, Voltage Reference VCC, ADC2 (PB4)
+	ADMUX = _BV(MUX1);
+	// ADC Enable, Prescaler 16 to Have ADC Clock 1Mhz
+	ADCSRA = _BV(ADEN)|_BV(ADPS2);
+#endif
+
+	/* Counters */
+	// Timer/Counter1: Counter Reset
+	TCNT1 = 0;
+	// Timer/Counter1: Set Output Compare A
+	OCR1A = PWM_BIAS;
+	// Timer/Counter1: Set Output Compare C
+	OCR1C = 0xFF;
+	// Timer/Counter1: Dead Time of OC1A (DT1AH) and !OC1A (DT1AL)
+	DTPS1 = DEAD_TIME_DTPS1;
+	DT1A = (DEAD_TIME_COUNT << 4)|DEAD_TIME_COUNT;
+	// Timer/Counter1: Select PWM Mode of OC1A and Output from OC1A and !OC1A, Start Counter with PLL Clock 64.0MHz / 256 (OCR1C + 1) = 250kHz
+	TCCR1 = _BV(PWM1A)|_BV(COM1A0)|_BV(CS10);
+	// Timer/Counter0: Counter Reset
+	TCNT0 = 0;
+	// Timer/Counter0: Set Output Compare A as TOP
+	OCR0A = 52;
+	// Set Timer/Counter0 Output Compare Match A Interrupt for "ISR(TIMER0_COMPA_vect)"
+	TIMSK = _BV(OCIE0A);
+	// Timer/Counter0: Select CTC Mode (2)
+	TCCR0A = _BV(WGM01);
+	// Start Counter with I/O-Clock 16.0MHz / ( 8 * 53 ) = Approx. 37735.85Hz
+	TCCR0B = _BV(CS01);
+
+	/* Preperation to Enter Loop */
+	// For First Obtention of ADC Value on Loop
+	ADCSRA |= start_adc;
+	// Counter Reset
+	TCNT0 = 0;
+	// Start to Issue Interrupt
+	sei();
+
+	while(1) {
+	}
+	return 0;
+}
+
+ISR(TIMER0_COMPA_vect, ISR_NAKED) { // No Need to Save Registers and SREG Before Entering ISR
+	/* Declare and Define Local Constants and Variables */
+	uint8_t const start_adc = _BV(ADSC);
+#if INPUT_DIFFERENTIAL
+	uint8_t const pin_input = _BV(PINB2); // Assign PB2 as Gain Bit[0]
+#else
+	uint8_t const pin_input = _BV(PINB3)|_BV(PINB2); // Assign PB3 and PB2 as Gain Bit[1:0]
+#endif
+	uint8_t const pin_input_shift = PINB2;
+	adc16 adc_sample;
+	uint8_t input_pin;
+
+	adc_sample.value8.lower = ADCL;
+	adc_sample.value8.upper = ADCH;
+	ADCSRA |= start_adc; // For Next Sampling
+
+	input_pin = ((PINB ^ pin_input) & pin_input) >> pin_input_shift;
+	if ( input_pin == input_pin_last ) { // If Match
+		if ( ! --input_sensitivity_count ) { // If Count Reaches Zero
+			input_pin_buffer = input_pin;
+			input_sensitivity_count = INPUT_SENSITIVITY;
+#if INPUT_DIFFERENTIAL
+			ADMUX = input_pin_buffer ? ADMUX_DIFFERENTIAL_20X : ADMUX_DIFFERENTIAL_1X; // Applied from the Next Conversion
+#endif
+		}
+	} else { // If Not Match
+		input_pin_last = input_pin;
+		input_sensitivity_count = INPUT_SENSITIVITY;
+	}
+
+#if INPUT_DIFFERENTIAL
+	adc_sign_extend( &adc_sample );
+	adc_sample.value16 -= adc_offset[input_pin_buffer];
+#else
+	adc_sample.value16 -= ADC_BIAS_DEFAULT;
+	// Arithmetic Left Shift (Signed Value in Bit[9:0], Bit[15:10] Same as Bit[9])
+	adc_sample.value16 <<= input_pin_buffer; // Gain Bit[1:0]
+#endif
+	adc_sample.value16 += PWM_BIAS; // Gain 12dB (Multiplier 4)
+	if ( adc_sample.value16 > PWM_CLIP_UPPER ) {
+		adc_sample.value16 = PWM_CLIP_UPPER;
+	}
+	if ( adc_sample.value16 < PWM_CLIP_UNDER ) {
+		adc_sample.value16 = PWM_CLIP_UNDER;
+	}
+	OCR1A = adc_sample.value8.lower;
+	reti();
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Parser of MIDI Messages Received via Software UART at 31250 Baud
+ * Call midi_receive() with each received byte, and handle the returned event.
+ * Running status is kept for channel messages. System real-time messages (0xF8-0xFF) can be interleaved in other messages,
+ * and don't change running status. System common messages and system exclusive (0xF0-0xF7) clear running status,
+ * so following data bytes are ignored until the next status byte.
+ * Note On with velocity 0 is Note Off. Only messages of midi_channel are handled unless midi_channel is MIDI_CHANNEL_OMNI.
+ */
+
+#define MIDI_BAUD_RATE 31250
+#define MIDI_CHANNEL_OMNI 0xFF
+#define MIDI_STATUS_BIT 0x80
+#define MIDI_STATUS_TYPE_MASK 0xF0
+#define MIDI_STATUS_CHANNEL_MASK 0x0F
+#define MIDI_STATUS_NOTE_OFF 0x80
+#define MIDI_STATUS_NOTE_ON 0x90
+#define MIDI_STATUS_PROGRAM_CHANGE 0xC0
+#define MIDI_STATUS_CHANNEL_PRESSURE 0xD0
+#define MIDI_STATUS_SYSTEM 0xF0
+#define MIDI_STATUS_REAL_TIME 0xF8
+#define MIDI_STATUS_CLOCK 0xF8
+#define MIDI_STATUS_START 0xFA
+#define MIDI_STATUS_CONTINUE 0xFB
+#define MIDI_STATUS_STOP 0xFC
+#define MIDI_EVENT_NONE 0
+#define MIDI_EVENT_CLOCK 1
+#define MIDI_EVENT_START 2
+#define MIDI_EVENT_CONTINUE 3
+#define MIDI_EVENT_STOP 4
+#define MIDI_EVENT_NOTE_ON 5 // midi_note and midi_velocity Are Set
+#define MIDI_EVENT_NOTE_OFF 6 // midi_note Is Set
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint8_t midi_channel;
+uint8_t midi_status; // Running Status, 0 = None
+uint8_t midi_data_count;
+uint8_t midi_note;
+uint8_t midi_velocity;
+
+// channel: 0 to 15 (MIDI Channel 1 to 16), or MIDI_CHANNEL_OMNI
+static inline void midi_init( uint8_t channel ) {
+	midi_channel = channel;
+	midi_status = 0;
+	midi_data_count = 0;
+	midi_note = 0;
+	midi_velocity = 0;
+}
+
+// Return MIDI_EVENT_NONE or an event if a message is completed.
+static inline uint8_t midi_receive( uint8_t byte ) {
+	uint8_t type;
+	if ( byte & MIDI_STATUS_BIT ) {
+		if ( byte >= MIDI_STATUS_REAL_TIME ) {
+			switch ( byte ) {
+				case MIDI_STATUS_CLOCK:
+					return MIDI_EVENT_CLOCK;
+				case MIDI_STATUS_START:
+					return MIDI_EVENT_START;
+				case MIDI_STATUS_CONTINUE:
+					return MIDI_EVENT_CONTINUE;
+				case MIDI_STATUS_STOP:
+					return MIDI_EVENT_STOP;
+				default:
+					return MIDI_EVENT_NONE;
+			}
+		}
+		midi_data_count = 0;
+		if ( byte >= MIDI_STATUS_SYSTEM || (midi_channel != MIDI_CHANNEL_OMNI && (byte & MIDI_STATUS_CHANNEL_MASK) != midi_channel) ) {
+			midi_status = 0; // Ignore Data Bytes, But Other Channels Must Not Use Running Status of This Channel
+		} else {
+			midi_status = byte;
+		}
+		return MIDI_EVENT_NONE;
+	}
+	if ( ! midi_status ) return MIDI_EVENT_NONE;
+	type = midi_status & MIDI_STATUS_TYPE_MASK;
+	if ( type == MIDI_STATUS_PROGRAM_CHANGE || type == MIDI_STATUS_CHANNEL_PRESSURE ) return MIDI_EVENT_NONE; // One Data Byte, Not Handled
+	if ( ! midi_data_count ) {
+		midi_note = byte;
+		midi_data_count = 1;
+		return MIDI_EVENT_NONE;
+	}
+	midi_data_count = 0; // Next Data Byte Starts a Message with Running Status
+	if ( type == MIDI_STATUS_NOTE_ON && byte ) {
+		midi_velocity = byte;
+		return MIDI_EVENT_NOTE_ON;
+	} else if ( type == MIDI_STATUS_NOTE_ON || type == MIDI_STATUS_NOTE_OFF ) {
+		return MIDI_EVENT_NOTE_OFF;
+	}
+	return MIDI_EVENT_NONE;
+}
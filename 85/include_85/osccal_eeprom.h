@@ -0,0 +1,117 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Tuned OSCCAL in EEPROM, Measured with Bytes from the Host via Software UART
+ * Include this file after "include_85/software_uart.h".
+ * Address 510 is the value of OSCCAL, and address 511 is the inverted value as a marker (reserved in "include_85/sequencer_eeprom.h").
+ * Unwritten bytes in EEPROM are 0xFF, so the marker is not matched until the calibration is done.
+ * Program EESAVE of the high fuse (e.g., 0xD7) to keep EEPROM on reflashing.
+ *
+ * Calibration Command:
+ *  0xC3: Start Calibration, Reserved Out of Start and Stop Bytes of Groups (0x40-0x7F)
+ *  Group Number: Bit[7:4] of the group byte in Bit[3:0], e.g., 0x05 for 0x50 (P). Other groups ignore the command.
+ *  Note: Both bytes are out of 0x40-0x7F, so a lost command byte doesn't make the group byte stop the sequencer.
+ *  Note: After the command, the host sends bytes at SOFTWARE_UART_FREQUENCY (80Hz) from an accurate clock, e.g., clock bytes of the sequencer.
+ *        The device tracks OSCCAL with intervals of start bits (SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT),
+ *        and stores OSCCAL if tracking is stable for OSCCAL_EEPROM_STABLE_NUMBER measurements (1 second), then ends the calibration.
+ */
+
+#define OSCCAL_EEPROM_ADDRESS 510
+#define OSCCAL_EEPROM_COMMAND 0xC3
+#define OSCCAL_EEPROM_GROUP_MASK 0xF0
+#define OSCCAL_EEPROM_STABLE_NUMBER 5 // 0.2 Seconds per Measurement
+#define OSCCAL_EEPROM_STATUS_IDLE 0
+#define OSCCAL_EEPROM_STATUS_GROUP 1
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint8_t osccal_eeprom_status;
+uint8_t osccal_eeprom_group;
+volatile uint8_t osccal_eeprom_handler_mode; // Add to the Mode of software_uart_handler_rx_tx()
+
+// group_byte: Group Byte of This Device, e.g., SEQUENCER_BYTE_GROUP_BIT
+static inline void osccal_eeprom_init( uint8_t group_byte ) {
+	osccal_eeprom_status = OSCCAL_EEPROM_STATUS_IDLE;
+	osccal_eeprom_group = group_byte & OSCCAL_EEPROM_GROUP_MASK;
+	osccal_eeprom_handler_mode = 0;
+}
+
+static inline uint8_t osccal_eeprom_read_byte( uint16_t address ) {
+	while ( EECR & _BV(EEPE) ); // Wait for Writing
+	EEAR = address;
+	EECR |= _BV(EERE);
+	return EEDR;
+}
+
+// Blocking, approx. 3.4ms If the Byte Is Changed
+static inline void osccal_eeprom_write_byte( uint16_t address, uint8_t byte ) {
+	uint8_t sreg;
+	if ( osccal_eeprom_read_byte( address ) == byte ) return;
+	EECR = 0; // Erase and Write in One Operation (Atomic Operation)
+	EEDR = byte;
+	sreg = SREG;
+	cli(); // EEPE Must Be Set within Four Clock Cycles after Setting EEMPE
+	EECR |= _BV(EEMPE);
+	EECR |= _BV(EEPE);
+	SREG = sreg;
+}
+
+/**
+ * Return OSCCAL stored in EEPROM, or osccal_default if not stored.
+ * Set OSCCAL with osccal_eeprom_set() because the stored value may be far from the value at reset.
+ */
+static inline uint8_t osccal_eeprom_load( uint8_t osccal_default ) {
+	uint8_t value = osccal_eeprom_read_byte( OSCCAL_EEPROM_ADDRESS );
+	if ( osccal_eeprom_read_byte( OSCCAL_EEPROM_ADDRESS + 1 ) != (uint8_t)~value ) return osccal_default;
+	return value;
+}
+
+// Change OSCCAL one by one, because the datasheet prohibits changing the frequency more than 2% at once.
+static inline void osccal_eeprom_set( uint8_t value ) {
+	uint8_t osccal = OSCCAL;
+	if ( (osccal ^ value) & ~(SOFTWARE_UART_OSCCAL_STEP_MASK) ) { // Different Ranges, No Gradual Path
+		OSCCAL = value;
+		return;
+	}
+	while ( osccal != value ) {
+		if ( osccal < value ) {
+			osccal++;
+		} else {
+			osccal--;
+		}
+		OSCCAL = osccal;
+	}
+}
+
+/**
+ * Receive a byte from Rx, and return true (not zero) if the byte is consumed by the calibration command.
+ * If false (zero) is returned, handle the byte as a byte of the sequencer.
+ */
+static inline uint8_t osccal_eeprom_receive( uint8_t byte ) {
+	if ( osccal_eeprom_status == OSCCAL_EEPROM_STATUS_GROUP ) {
+		if ( byte == (osccal_eeprom_group >> 4) ) {
+			software_uart_track_stable = 0;
+			osccal_eeprom_handler_mode = SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT;
+		}
+		osccal_eeprom_status = OSCCAL_EEPROM_STATUS_IDLE;
+		return 1;
+	}
+	if ( byte != OSCCAL_EEPROM_COMMAND ) return 0;
+	osccal_eeprom_status = OSCCAL_EEPROM_STATUS_GROUP;
+	return 1;
+}
+
+// Store OSCCAL at the end of the calibration. Call this function in the main loop.
+static inline void osccal_eeprom_poll() {
+	uint8_t osccal;
+	if ( ! osccal_eeprom_handler_mode ) return;
+	if ( software_uart_track_stable < OSCCAL_EEPROM_STABLE_NUMBER ) return;
+	osccal_eeprom_handler_mode = 0;
+	osccal = OSCCAL;
+	osccal_eeprom_write_byte( OSCCAL_EEPROM_ADDRESS, osccal );
+	osccal_eeprom_write_byte( OSCCAL_EEPROM_ADDRESS + 1, ~osccal );
+}
@@ -0,0 +1,36 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Output Stage of Audio with PWM of Timer/Counter1 Clocked by PLL (64.0MHz)
+ * The carrier is 64.0MHz / 256 (OCR1C + 1) = 250kHz, so a simple RC filter removes it, compared with approx. 31.3kHz of Timer/Counter0.
+ * The output is !OC1A (PB0), the same pin as OC0A. OC1A (PB1) is not output unless DDB1 is set, don't set DDB1.
+ * !OC1A is inverted from OC1A, so values are inverted in pwm_pll_set() to make the same duty cycle as OCR0A.
+ * Timer/Counter1 has no interrupt, and Timer/Counter0 can keep making the sample rate without output (COM0A1:0 = 0b00).
+ * The PLL needs the internal RC oscillator (8.0MHz), it works with the system clock of 8.0MHz RC or 16.0MHz PLL.
+ */
+
+// Set !OC1A (PB0)
+static inline void pwm_pll_set( uint8_t value ) {
+	OCR1A = ~value;
+}
+
+static inline void pwm_pll_init( uint8_t value ) {
+	/* PLL On */
+	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
+	do {
+		_delay_us(100);
+	} while ( ! (PLLCSR & _BV(PLOCK)) );
+	PLLCSR |= _BV(PCKE);
+	// Timer/Counter1: Counter Reset
+	TCNT1 = 0;
+	// Timer/Counter1: Set Output Compare A
+	pwm_pll_set( value );
+	// Timer/Counter1: Set Output Compare C
+	OCR1C = 0xFF;
+	// Timer/Counter1: Select PWM Mode of OC1A, Output from !OC1A, and Start Counter with PLL Clock 64.0MHz / 256 (OCR1C + 1) = 250kHz
+	TCCR1 = _BV(PWM1A)|_BV(COM1A0)|_BV(CS10);
+}
@@ -0,0 +1,201 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Programs of Sequencer in EEPROM, Uploaded via Software UART
+ * Include this file after "sequencer.h" and "include/telemetry.h" (CRC-8).
+ * Define SEQUENCER_EEPROM_HANDLER_FREQUENCY in advance, and call sequencer_eeprom_handler_timeout() in the ISR at the frequency.
+ * Programs from 0 to (SEQUENCER_PROGRAM_LENGTH - 1) are in program space,
+ * and programs from SEQUENCER_EEPROM_PROGRAM_START to 7 are in EEPROM (SEQUENCER_PROGRAM_COUNTUPTO bytes per program).
+ * Unwritten bytes in EEPROM are 0xFF.
+ *
+ * Upload Command:
+ *  0xC5: Start of Command, Reserved Out of Start and Stop Bytes of Groups (0x40-0x7F)
+ *  Group Number: Bit[7:4] of the group byte in Bit[3:0], e.g., 0x05 for 0x50 (P). Other groups ignore the command.
+ *  Program Index: SEQUENCER_EEPROM_PROGRAM_START to 7
+ *  Offset: Step to Start Writing, 0 to (SEQUENCER_PROGRAM_COUNTUPTO - 1)
+ *  Length - 1: 0 to (SEQUENCER_PROGRAM_COUNTUPTO - Offset - 1)
+ *  Data: Bytes of Length
+ *  CRC-8: Calculated from Program Index to the End of Data (see include/telemetry.h)
+ *  Note: Bytes from the command to the length are out of 0x40-0x7F, so a lost command byte doesn't start or stop the sequencer by the header.
+ *        Bytes of data and CRC may be in 0x40-0x7F, and they start or stop the sequencer if the command byte is lost.
+ *        All bytes of the command are consumed, i.e., data bytes don't clock or stop the sequencer.
+ *        Data is written only if the header is valid and the CRC is matched. The sequencer keeps playing during writing.
+ *        Writing a byte to EEPROM takes approx. 3.4ms. Wait for (Length * 4ms) before sending the next command.
+ *        Send bytes of a command back to back. If no byte comes for SEQUENCER_EEPROM_TIMEOUT, the command is discarded,
+ *        so a lost byte doesn't make the command swallow following bytes of the sequencer, e.g., clock bytes at 80Hz (12.5ms).
+ */
+
+#define SEQUENCER_EEPROM_COMMAND 0xC5
+#define SEQUENCER_EEPROM_TIMEOUT 10 // Milliseconds, Longer Than a Byte at 1200 Baud (8.3ms), Shorter Than Clock Bytes at 80Hz (12.5ms)
+#define SEQUENCER_EEPROM_TIMEOUT_DIVISOR ((SEQUENCER_EEPROM_HANDLER_FREQUENCY + 500) / 1000) // Calls of Handler per Millisecond
+#define SEQUENCER_EEPROM_GROUP_MASK 0xF0
+#define SEQUENCER_EEPROM_PROGRAM_START SEQUENCER_PROGRAM_LENGTH
+#define SEQUENCER_EEPROM_PROGRAM_END 8 // Bit[2:0] Selects a Program
+#define SEQUENCER_EEPROM_SIZE 510 // Last 2 Bytes Are Reserved
+#define SEQUENCER_EEPROM_CACHE_SIZE 8 // Must Be Power of 2
+#define SEQUENCER_EEPROM_CACHE_INVALID 0xFFFF
+#define SEQUENCER_EEPROM_STATUS_IDLE 0
+#define SEQUENCER_EEPROM_STATUS_GROUP 1
+#define SEQUENCER_EEPROM_STATUS_INDEX 2
+#define SEQUENCER_EEPROM_STATUS_OFFSET 3
+#define SEQUENCER_EEPROM_STATUS_LENGTH 4
+#define SEQUENCER_EEPROM_STATUS_DATA 5
+#define SEQUENCER_EEPROM_STATUS_CRC 6
+
+#ifndef SEQUENCER_EEPROM_HANDLER_FREQUENCY
+#error "Define SEQUENCER_EEPROM_HANDLER_FREQUENCY before include_85/sequencer_eeprom.h."
+#endif
+
+_Static_assert( SEQUENCER_EEPROM_TIMEOUT_DIVISOR >= 1 && SEQUENCER_EEPROM_TIMEOUT_DIVISOR <= 0xFF, "SEQUENCER_EEPROM_TIMEOUT_DIVISOR must fit in 8 bits." );
+_Static_assert( (SEQUENCER_EEPROM_PROGRAM_END - SEQUENCER_EEPROM_PROGRAM_START) * SEQUENCER_PROGRAM_COUNTUPTO <= SEQUENCER_EEPROM_SIZE, "Programs in EEPROM exceed the size." );
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+uint8_t sequencer_eeprom_status;
+volatile uint8_t sequencer_eeprom_timeout; // Milliseconds to Discard the Command
+uint8_t sequencer_eeprom_timeout_divisor;
+uint8_t sequencer_eeprom_is_discard;
+uint8_t sequencer_eeprom_group;
+uint8_t sequencer_eeprom_index;
+uint8_t sequencer_eeprom_offset;
+uint8_t sequencer_eeprom_length;
+uint8_t sequencer_eeprom_count;
+uint8_t sequencer_eeprom_crc;
+uint8_t sequencer_eeprom_buffer[SEQUENCER_PROGRAM_COUNTUPTO];
+uint16_t sequencer_eeprom_write_address;
+uint8_t sequencer_eeprom_write_index;
+uint8_t sequencer_eeprom_write_length;
+uint16_t sequencer_eeprom_cache_address; // Address of First Byte in Cache
+uint8_t sequencer_eeprom_cache[SEQUENCER_EEPROM_CACHE_SIZE];
+
+// group_byte: Group Byte of This Device, e.g., SEQUENCER_BYTE_GROUP_BIT
+static inline void sequencer_eeprom_init( uint8_t group_byte ) {
+	sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_IDLE;
+	sequencer_eeprom_timeout = 0;
+	sequencer_eeprom_timeout_divisor = SEQUENCER_EEPROM_TIMEOUT_DIVISOR;
+	sequencer_eeprom_group = group_byte & SEQUENCER_EEPROM_GROUP_MASK;
+	sequencer_eeprom_write_index = 0;
+	sequencer_eeprom_write_length = 0;
+	sequencer_eeprom_cache_address = SEQUENCER_EEPROM_CACHE_INVALID;
+}
+
+static inline uint16_t sequencer_eeprom_address( uint8_t program_index, uint8_t step ) {
+	return (uint16_t)(program_index - SEQUENCER_EEPROM_PROGRAM_START) * SEQUENCER_PROGRAM_COUNTUPTO + step;
+}
+
+// Call in the ISR at SEQUENCER_EEPROM_HANDLER_FREQUENCY
+static inline void sequencer_eeprom_handler_timeout() {
+	if ( --sequencer_eeprom_timeout_divisor ) return;
+	sequencer_eeprom_timeout_divisor = SEQUENCER_EEPROM_TIMEOUT_DIVISOR;
+	if ( sequencer_eeprom_timeout ) sequencer_eeprom_timeout--;
+}
+
+/**
+ * Receive a byte from Rx, and return true (not zero) if the byte is consumed by the upload command.
+ * If false (zero) is returned, handle the byte as a byte of the sequencer.
+ */
+static inline uint8_t sequencer_eeprom_receive( uint8_t byte ) {
+	if ( ! sequencer_eeprom_timeout ) sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_IDLE; // Resync after Lost Bytes
+	sequencer_eeprom_timeout = SEQUENCER_EEPROM_TIMEOUT + 1; // Decremented at the Next Millisecond or Later
+	switch ( sequencer_eeprom_status ) {
+		case SEQUENCER_EEPROM_STATUS_IDLE:
+			if ( byte != SEQUENCER_EEPROM_COMMAND ) return 0;
+			// Discard If Previous Data Is Being Written, Because the Buffer Is in Use
+			sequencer_eeprom_is_discard = sequencer_eeprom_write_index < sequencer_eeprom_write_length;
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_GROUP;
+			break;
+		case SEQUENCER_EEPROM_STATUS_GROUP:
+			if ( byte != (sequencer_eeprom_group >> 4) ) sequencer_eeprom_is_discard = 1;
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_INDEX;
+			break;
+		case SEQUENCER_EEPROM_STATUS_INDEX:
+			if ( byte < SEQUENCER_EEPROM_PROGRAM_START || byte >= SEQUENCER_EEPROM_PROGRAM_END ) sequencer_eeprom_is_discard = 1;
+			sequencer_eeprom_index = byte;
+			sequencer_eeprom_crc = telemetry_crc8( 0, byte );
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_OFFSET;
+			break;
+		case SEQUENCER_EEPROM_STATUS_OFFSET:
+			if ( byte >= SEQUENCER_PROGRAM_COUNTUPTO ) sequencer_eeprom_is_discard = 1;
+			sequencer_eeprom_offset = byte;
+			sequencer_eeprom_crc = telemetry_crc8( sequencer_eeprom_crc, byte );
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_LENGTH;
+			break;
+		case SEQUENCER_EEPROM_STATUS_LENGTH:
+			if ( byte >= SEQUENCER_PROGRAM_COUNTUPTO ) { // Unable to Know the End of Command
+				sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_IDLE;
+				break;
+			}
+			if ( byte >= SEQUENCER_PROGRAM_COUNTUPTO - sequencer_eeprom_offset ) sequencer_eeprom_is_discard = 1;
+			sequencer_eeprom_length = byte + 1; // Length - 1 in the Command
+			sequencer_eeprom_count = 0;
+			sequencer_eeprom_crc = telemetry_crc8( sequencer_eeprom_crc, byte );
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_DATA;
+			break;
+		case SEQUENCER_EEPROM_STATUS_DATA:
+			if ( ! sequencer_eeprom_is_discard ) sequencer_eeprom_buffer[sequencer_eeprom_count] = byte;
+			sequencer_eeprom_crc = telemetry_crc8( sequencer_eeprom_crc, byte );
+			if ( ++sequencer_eeprom_count >= sequencer_eeprom_length ) sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_CRC;
+			break;
+		case SEQUENCER_EEPROM_STATUS_CRC:
+			if ( ! sequencer_eeprom_is_discard && byte == sequencer_eeprom_crc ) {
+				sequencer_eeprom_write_address = sequencer_eeprom_address( sequencer_eeprom_index, sequencer_eeprom_offset );
+				sequencer_eeprom_write_index = 0;
+				sequencer_eeprom_write_length = sequencer_eeprom_length;
+			}
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_IDLE;
+			break;
+		default:
+			sequencer_eeprom_status = SEQUENCER_EEPROM_STATUS_IDLE;
+			break;
+	}
+	return 1;
+}
+
+/**
+ * Write a byte to EEPROM if EEPROM is ready. Call this function in the main loop.
+ * The byte is not written if it is the same as the byte in EEPROM to save the endurance.
+ */
+static inline void sequencer_eeprom_write_poll() {
+	uint16_t address;
+	uint8_t byte;
+	uint8_t sreg;
+	if ( sequencer_eeprom_write_index >= sequencer_eeprom_write_length ) return;
+	if ( EECR & _BV(EEPE) ) return; // Previous Writing Is in Progress
+	address = sequencer_eeprom_write_address + sequencer_eeprom_write_index;
+	byte = sequencer_eeprom_buffer[sequencer_eeprom_write_index++];
+	// Write Through to Cache
+	if ( (address & ~(SEQUENCER_EEPROM_CACHE_SIZE - 1)) == sequencer_eeprom_cache_address ) sequencer_eeprom_cache[address & (SEQUENCER_EEPROM_CACHE_SIZE - 1)] = byte;
+	EEAR = address;
+	EECR |= _BV(EERE);
+	if ( EEDR == byte ) return;
+	EECR = 0; // Erase and Write in One Operation (Atomic Operation)
+	EEDR = byte;
+	sreg = SREG;
+	cli(); // EEPE Must Be Set within Four Clock Cycles after Setting EEMPE
+	EECR |= _BV(EEMPE);
+	EECR |= _BV(EEPE);
+	SREG = sreg;
+}
+
+/**
+ * Read a byte of a program in EEPROM through the cache.
+ * Reading EEPROM halts CPU and waits for writing, so the cache reads a line of SEQUENCER_EEPROM_CACHE_SIZE bytes at once.
+ */
+static inline uint8_t sequencer_eeprom_read( uint8_t program_index, uint8_t step ) {
+	uint16_t address = sequencer_eeprom_address( program_index, step );
+	uint16_t cache_address = address & ~(SEQUENCER_EEPROM_CACHE_SIZE - 1);
+	if ( cache_address != sequencer_eeprom_cache_address ) {
+		while ( EECR & _BV(EEPE) ); // Wait for Writing
+		for ( uint8_t i = 0; i < SEQUENCER_EEPROM_CACHE_SIZE; i++ ) {
+			EEAR = cache_address + i;
+			EECR |= _BV(EERE);
+			sequencer_eeprom_cache[i] = EEDR;
+		}
+		sequencer_eeprom_cache_address = cache_address;
+	}
+	return sequencer_eeprom_cache[address & (SEQUENCER_EEPROM_CACHE_SIZE - 1)];
+}
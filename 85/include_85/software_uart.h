@@ -21,16 +21,54 @@
 #define SOFTWARE_UART_PIN_RX PINB4 // Use undef to Redefine Pinout
 #define SOFTWARE_UART_DATA_BIT_NUMBER 8 // Must Be Maximum 8
 #define SOFTWARE_UART_STOP_BIT_NUMBER 1 // Must Be Minimum 1
-#define SOFTWARE_UART_BAUD_RATE 1200
-#define SOFTWARE_UART_INTERVAL_RX_FIRST 12
-#define SOFTWARE_UART_INTERVAL 8
+#ifndef SOFTWARE_UART_BAUD_RATE
+#define SOFTWARE_UART_BAUD_RATE 1200 // Define with Intervals in Advance to Change, e.g., 31250 for MIDI
+#define SOFTWARE_UART_INTERVAL_RX_FIRST 12 // 1.5 Bits
+#define SOFTWARE_UART_INTERVAL 8 // Calls of Handler per Bit
+#endif
+#ifndef SOFTWARE_UART_CALIBRATION
+#define SOFTWARE_UART_CALIBRATION 1 // 0 = Omit Counters to Calibrate OSCCAL If Bytes Have No Fixed Interval
+#endif
 #define SOFTWARE_UART_STATUS_RX_COUNTER_BIT_MASK 0x0F
 #define SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT (0b1 << 4)
+#define SOFTWARE_UART_STATUS_RX_CUT_THROUGH_BIT (0b1 << 5)
 #define SOFTWARE_UART_STATUS_RX_FREQ_COUNTER_START_BIT (0b1 << 7)
 #define SOFTWARE_UART_FREQUENCY 80 // Hz
 #define SOFTWARE_UART_COMPARE_VALUE (SOFTWARE_UART_BAUD_RATE * SOFTWARE_UART_INTERVAL)
 #define SOFTWARE_UART_COMPARE_TIMEOUT (SOFTWARE_UART_COMPARE_VALUE * 2)
 #define SOFTWARE_UART_COMPARE_THRESHOLD 48 // 0.5% of SOFTWARE_UART_COMPARE_VALUE
+#define SOFTWARE_UART_TX_COUNT_START (1 + SOFTWARE_UART_DATA_BIT_NUMBER + SOFTWARE_UART_STOP_BIT_NUMBER) // Start, Data, and Stop Bits
+
+/**
+ * Cut-through (SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT):
+ * Tx starts the start bit SOFTWARE_UART_CUT_THROUGH_DELAY - 1 loops after the start bit of Rx is detected,
+ * so each data bit of Tx is output in the same loop as the sample of Rx, because Rx is handled before Tx.
+ * The delay is approx. 0.5 bit instead of a frame (10 bits) in the loop back after the stop bit.
+ * Bits are regenerated with the clock of this device. If Tx is busy at the start bit of Rx, the byte is looped back after the stop bit.
+ */
+#define SOFTWARE_UART_CUT_THROUGH_DELAY (SOFTWARE_UART_INTERVAL_RX_FIRST - SOFTWARE_UART_INTERVAL + 1)
+
+/**
+ * Tracking of OSCCAL (SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT):
+ * Counts handler loops between start bits directly, and sums SOFTWARE_UART_TRACK_BYTE_NUMBER intervals (0.2 seconds).
+ * Each interval must be approx. SOFTWARE_UART_TRACK_INTERVAL loops, otherwise a byte is lost or a start bit is false, and the sum restarts.
+ * One step of OSCCAL is approx. 10.6 loops of the sum, so the step is the error divided by 16 (approx. 2/3 of the error) to avoid overshoot.
+ * OSCCAL is changed one by one because the datasheet prohibits changing the frequency more than 2% at once.
+ * OSCCAL stays within the current range (0x00-0x7F or 0x80-0xFF), crossing the ranges changes the frequency approx. 35%.
+ */
+#define SOFTWARE_UART_TRACK_BYTE_NUMBER 16
+#define SOFTWARE_UART_TRACK_INTERVAL (SOFTWARE_UART_COMPARE_VALUE / SOFTWARE_UART_FREQUENCY) // 120 Loops per Byte
+#define SOFTWARE_UART_TRACK_INTERVAL_MARGIN (SOFTWARE_UART_TRACK_INTERVAL >> 2) // 25%
+#define SOFTWARE_UART_TRACK_COMPARE_VALUE (SOFTWARE_UART_TRACK_INTERVAL * SOFTWARE_UART_TRACK_BYTE_NUMBER)
+#define SOFTWARE_UART_TRACK_THRESHOLD 7 // 0.36%, More Than Half of a Step of OSCCAL Not to Hunt
+#define SOFTWARE_UART_TRACK_GAIN_SHIFT 4
+#define SOFTWARE_UART_TRACK_STEP_MAX 8
+#define SOFTWARE_UART_OSCCAL_STEP_MASK 0x7F // Bit[7] Selects the Range
+
+#if SOFTWARE_UART_CALIBRATION
+_Static_assert( SOFTWARE_UART_TRACK_INTERVAL + SOFTWARE_UART_TRACK_INTERVAL_MARGIN < 0xFF, "Interval of tracking exceeds 8 bits." );
+_Static_assert( SOFTWARE_UART_COMPARE_TIMEOUT <= 0xFFFF, "Counter of calibration exceeds 16 bits." );
+#endif
 
 volatile uint8_t software_uart_tx_count;
 volatile uint8_t software_uart_tx_interval_count;
@@ -41,6 +79,10 @@ volatile uint8_t software_uart_rx_byte;
 volatile uint8_t software_uart_rx_byte_buffer;
 volatile uint16_t software_uart_freq_counter_handler_loop;
 volatile uint16_t software_uart_freq_counter_byte;
+volatile uint8_t software_uart_track_interval;
+volatile uint8_t software_uart_track_count;
+volatile uint16_t software_uart_track_sum;
+volatile uint8_t software_uart_track_stable; // Number of Measurements without Steps, Saturated at 0xFF
 
 static inline void software_uart_init() {
 	software_uart_tx_count = 0;
@@ -52,19 +94,85 @@ static inline void software_uart_init() {
 	software_uart_rx_byte_buffer = 0;
 	software_uart_freq_counter_handler_loop = 0;
 	software_uart_freq_counter_byte = 0;
+	software_uart_track_interval = 0xFF;
+	software_uart_track_count = 0;
+	software_uart_track_sum = 0;
+	software_uart_track_stable = 0;
+}
+
+/**
+ * Set software_uart_tx_byte and software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START to send a byte.
+ * software_uart_tx_count reaches zero after the last stop bit, so zero means Tx is idle and ready to send the next byte.
+ */
+static inline uint8_t software_uart_tx_is_ready() {
+	return ! software_uart_tx_count;
+}
+
+// Blocking Tx, Interrupt of the Handler Must Be Enabled
+static inline void software_uart_tx_put( uint8_t byte ) {
+	while ( ! software_uart_tx_is_ready() );
+	software_uart_tx_byte = byte;
+	software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+}
+
+// Add steps to OSCCAL one by one within the current range.
+static inline void software_uart_osccal_step( int8_t step ) {
+	uint8_t osccal = OSCCAL;
+	while ( step > 0 && (osccal & SOFTWARE_UART_OSCCAL_STEP_MASK) != SOFTWARE_UART_OSCCAL_STEP_MASK ) {
+		OSCCAL = ++osccal;
+		step--;
+	}
+	while ( step < 0 && (osccal & SOFTWARE_UART_OSCCAL_STEP_MASK) ) {
+		OSCCAL = --osccal;
+		step++;
+	}
+}
+
+// Call on each start bit in tracking mode.
+static inline void software_uart_track() {
+	uint8_t interval = software_uart_track_interval;
+	int16_t compare_counter;
+	int8_t step;
+	software_uart_track_interval = 0;
+	if ( interval < SOFTWARE_UART_TRACK_INTERVAL - SOFTWARE_UART_TRACK_INTERVAL_MARGIN || interval > SOFTWARE_UART_TRACK_INTERVAL + SOFTWARE_UART_TRACK_INTERVAL_MARGIN ) { // First, Lost, or False
+		software_uart_track_count = 0;
+		software_uart_track_sum = 0;
+		return;
+	}
+	software_uart_track_sum += interval;
+	if ( ++software_uart_track_count < SOFTWARE_UART_TRACK_BYTE_NUMBER ) return;
+	compare_counter = software_uart_track_sum - SOFTWARE_UART_TRACK_COMPARE_VALUE;
+	software_uart_track_count = 0;
+	software_uart_track_sum = 0;
+	if ( compare_counter > -SOFTWARE_UART_TRACK_THRESHOLD && compare_counter < SOFTWARE_UART_TRACK_THRESHOLD ) {
+		if ( software_uart_track_stable != 0xFF ) software_uart_track_stable++;
+		return;
+	}
+	software_uart_track_stable = 0;
+	step = compare_counter >> SOFTWARE_UART_TRACK_GAIN_SHIFT; // Arithmetic Shift Rounds to Negative Infinity
+	if ( ! step ) step = (compare_counter > 0) ? 1 : -1;
+	if ( step > SOFTWARE_UART_TRACK_STEP_MAX ) step = SOFTWARE_UART_TRACK_STEP_MAX;
+	if ( step < -SOFTWARE_UART_TRACK_STEP_MAX ) step = -SOFTWARE_UART_TRACK_STEP_MAX;
+	software_uart_osccal_step( -step ); // Fast Clock Makes More Loops, Decrease OSCCAL
 }
 
 /**
  * handler_rx_tx_mode:
- * Bit[0]: Clear = Normal, 1 = Loop Back
- * Bit[1]: Clear = Only Clear Counter, 1 = 1 = Compare to Adjust OSCCAL and Clear Counters
+ * Bit[1]: Clear = Normal, 1 = Loop Back
+ * Bit[2]: Clear = Only Clear Counter, 1 = Compare to Adjust OSCCAL and Clear Counters (One Step per SOFTWARE_UART_FREQUENCY Bytes)
+ * Bit[3]: Clear = No Tracking, 1 = Track OSCCAL with Intervals of Start Bits (Proportional Steps), Don't Set with Bit[2]
+ * Bit[4]: Clear = No Cut-through, 1 = Cut-through, Loop Back after the Stop Bit If Tx Is Busy
  */
 #define SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT (0b1 << 1)
 #define SOFTWARE_UART_HANDLER_RX_TX_MODE_ADJUST_OSC_BIT (0b1 << 2)
+#define SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT (0b1 << 3)
+#define SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT (0b1 << 4)
 static inline void software_uart_handler_rx_tx( uint8_t handler_rx_tx_mode ) {
 	uint8_t uart_is_high;
 	uint8_t uart_status_rx_counter;
+#if SOFTWARE_UART_CALIBRATION
 	int16_t compare_counter;
+#endif
 	uart_is_high = (PINB & _BV(SOFTWARE_UART_PIN_RX)) >> SOFTWARE_UART_PIN_RX; // Shift Right to Make 0b1 for Further Process
 	uart_status_rx_counter = software_uart_rx_status & SOFTWARE_UART_STATUS_RX_COUNTER_BIT_MASK;
 	if ( ! uart_status_rx_counter ) {
@@ -72,50 +180,75 @@ static inline void software_uart_handler_rx_tx( uint8_t handler_rx_tx_mode ) {
 			software_uart_rx_status += 0b1;
 			software_uart_rx_interval_count = SOFTWARE_UART_INTERVAL_RX_FIRST;
 			software_uart_rx_byte = 0;
+#if SOFTWARE_UART_CALIBRATION
+			if ( handler_rx_tx_mode & SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT ) software_uart_track();
+#endif
+			if ( (handler_rx_tx_mode & SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT) && ! software_uart_tx_count ) {
+				software_uart_rx_status |= SOFTWARE_UART_STATUS_RX_CUT_THROUGH_BIT;
+				software_uart_tx_byte = 0;
+				software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+				software_uart_tx_interval_count = SOFTWARE_UART_CUT_THROUGH_DELAY;
+			}
+#if SOFTWARE_UART_CALIBRATION
 			if ( ! (software_uart_rx_status & SOFTWARE_UART_STATUS_RX_FREQ_COUNTER_START_BIT) ) {
 				software_uart_freq_counter_handler_loop = 0;
 				software_uart_rx_status |= SOFTWARE_UART_STATUS_RX_FREQ_COUNTER_START_BIT;
 			}
+#endif
 		}
 	} else {
 		if ( --software_uart_rx_interval_count == 0 ) {
 			software_uart_rx_interval_count = SOFTWARE_UART_INTERVAL;
 			if ( uart_status_rx_counter <= SOFTWARE_UART_DATA_BIT_NUMBER ) {
 				software_uart_rx_status += 0b1;
-				software_uart_rx_byte |= uart_is_high << (uart_status_rx_counter - 1);
+				// Shift in from MSB, Constant Shifts Are Faster Than Shifts by the Counter on AVR
+				software_uart_rx_byte = (software_uart_rx_byte >> 1)|(uart_is_high << 7);
+				if ( software_uart_rx_status & SOFTWARE_UART_STATUS_RX_CUT_THROUGH_BIT ) software_uart_tx_byte = uart_is_high; // Output in This Call
 			} else {
 				if ( uart_is_high ) {
 					software_uart_rx_status += 0b1;
 					if ( (uart_status_rx_counter - SOFTWARE_UART_DATA_BIT_NUMBER) >= SOFTWARE_UART_STOP_BIT_NUMBER ) {
+#if SOFTWARE_UART_DATA_BIT_NUMBER < 8
+						software_uart_rx_byte >>= 8 - SOFTWARE_UART_DATA_BIT_NUMBER; // Align LSB
+#endif
 						software_uart_rx_byte_buffer = software_uart_rx_byte;
 						software_uart_rx_status = (software_uart_rx_status & ~(SOFTWARE_UART_STATUS_RX_COUNTER_BIT_MASK)) ^ SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT; // Clear Counter and Flip Buffer Change Bit
-						if ( handler_rx_tx_mode & SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT ) {
+						if ( software_uart_rx_status & SOFTWARE_UART_STATUS_RX_CUT_THROUGH_BIT ) {
+							software_uart_rx_status &= ~(SOFTWARE_UART_STATUS_RX_CUT_THROUGH_BIT); // Already Sent
+						} else if ( handler_rx_tx_mode & (SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT|SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT) ) {
 							software_uart_tx_byte = software_uart_rx_byte;
-							software_uart_tx_count = 9;
+							software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
 						}
+#if SOFTWARE_UART_CALIBRATION
 						software_uart_freq_counter_byte++;
+#endif
 					}
 				}
 			}
 		}
 	}
+	// Interval Counts Even If Tx Is Idle, so a Byte Starts within SOFTWARE_UART_INTERVAL Calls and after a Full Stop Bit
 	if ( --software_uart_tx_interval_count == 0 ) {
 		software_uart_tx_interval_count = SOFTWARE_UART_INTERVAL;
-		if ( software_uart_tx_count > SOFTWARE_UART_DATA_BIT_NUMBER ) {
-			PORTB &= ~(_BV(SOFTWARE_UART_PIN_TX));
-			--software_uart_tx_count;
-		} else if ( software_uart_tx_count > 0 ) {
-			if ( software_uart_tx_byte & _BV(SOFTWARE_UART_DATA_BIT_NUMBER - software_uart_tx_count) ) {
-				PORTB |= _BV(SOFTWARE_UART_PIN_TX);
-			} else {
+		if ( software_uart_tx_count ) { // Line Stays High If Idle
+			if ( software_uart_tx_count > SOFTWARE_UART_DATA_BIT_NUMBER + SOFTWARE_UART_STOP_BIT_NUMBER ) {
 				PORTB &= ~(_BV(SOFTWARE_UART_PIN_TX));
+			} else if ( software_uart_tx_count > SOFTWARE_UART_STOP_BIT_NUMBER ) {
+				// Shift out from LSB
+				if ( software_uart_tx_byte & 0b1 ) {
+					PORTB |= _BV(SOFTWARE_UART_PIN_TX);
+				} else {
+					PORTB &= ~(_BV(SOFTWARE_UART_PIN_TX));
+				}
+				software_uart_tx_byte >>= 1;
+			} else {
+				PORTB |= _BV(SOFTWARE_UART_PIN_TX); // Stop Bits, Count Reaches Zero After Last Stop Bit
 			}
 			--software_uart_tx_count;
-		} else {
-			PORTB |= _BV(SOFTWARE_UART_PIN_TX);
-			software_uart_tx_interval_count += (SOFTWARE_UART_STOP_BIT_NUMBER - 1) * SOFTWARE_UART_INTERVAL;
 		}
 	}
+#if SOFTWARE_UART_CALIBRATION
+	if ( software_uart_track_interval != 0xFF ) software_uart_track_interval++; // Saturated
 	if ( ++software_uart_freq_counter_handler_loop >= SOFTWARE_UART_COMPARE_TIMEOUT ) {
 		software_uart_freq_counter_handler_loop = 0;
 		software_uart_freq_counter_byte = 0;
@@ -128,10 +261,11 @@ static inline void software_uart_handler_rx_tx( uint8_t handler_rx_tx_mode ) {
 		software_uart_rx_status &= ~(SOFTWARE_UART_STATUS_RX_FREQ_COUNTER_START_BIT);
 		if ( handler_rx_tx_mode & SOFTWARE_UART_HANDLER_RX_TX_MODE_ADJUST_OSC_BIT ) {
 			if ( compare_counter >= SOFTWARE_UART_COMPARE_THRESHOLD ) {
-				if ( OSCCAL > 0 ) OSCCAL--;
+				software_uart_osccal_step( -1 );
 			} else if ( compare_counter <= -SOFTWARE_UART_COMPARE_THRESHOLD ) {
-				if ( OSCCAL < 0x80 ) OSCCAL++;
+				software_uart_osccal_step( 1 ); // Not to Cross 0x7F and 0x80
 			}
 		}
 	}
+#endif
 }
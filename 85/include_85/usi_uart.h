@@ -0,0 +1,175 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * UART with Universal Serial Interface (USI) of ATtiny85, Half Duplex
+ * The shift register of USI is clocked by Timer/Counter0 Compare Match A at the baud rate, so the handlers are called only four times per byte,
+ * i.e., the start bit (PCINT0_vect), the last data bit of Rx (USI_OVF_vect), and two parts of Tx (USI_OVF_vect).
+ * Compare with include_85/software_uart.h which calls the handler 8 times per bit (80 times per byte) and even if the line is idle.
+ * Set Timer/Counter0 to CTC Mode with OCR0A = USI_UART_COMPARE_VALUE and TCCR0B = USI_UART_CLOCK_SELECT, and don't use Timer/Counter0 for other purposes.
+ * Call usi_uart_handler_start() in ISR(PCINT0_vect) and usi_uart_handler_overflow() in ISR(USI_OVF_vect).
+ *
+ * USI has only one shift register, so Rx and Tx can't be active at the same time.
+ *  A byte put during Rx is sent after Rx, and Rx doesn't detect the start bit of a byte received during Tx.
+ *  With the loop back mode, the host should send bytes at intervals of two frames or more.
+ * USI shifts MSB first, so bytes are reversed to make LSB first of UART.
+ * DO outputs bits shifted from DI during Rx, so Tx is turned to the input with pull-up during Rx. Set PORTB1 (Tx) high.
+ *
+ * Names of include_85/software_uart.h for Rx and Tx are defined as aliases at the end of this file, except the initialization and handlers.
+ *  software_uart_tx_count is read only, it's not zero while Tx is busy or pending.
+ *  Tx of USI must be started by a function, not by the handler, because no handler is called while the line is idle.
+ *  So replace "software_uart_tx_byte = byte; software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;" with software_uart_tx_put( byte ).
+ *  SOFTWARE_UART_TX_COUNT_START is not defined, so code of the replaced way is stopped by the compiler.
+ */
+
+#ifdef SOFTWARE_UART_PIN_TX
+#error "include_85/usi_uart.h can't be included with include_85/software_uart.h."
+#endif
+
+#define USI_UART_PIN_TX PB1 // DO of USI, Fixed
+#define USI_UART_PIN_RX PINB0 // DI of USI, Fixed
+#define USI_UART_STOP_BIT_NUMBER 1 // Must Be 1 or 2
+#ifndef USI_UART_BAUD_RATE
+#define USI_UART_BAUD_RATE 19200 // Define with Prescaler in Advance to Change, e.g., 1200 with Prescaler 64
+#define USI_UART_PRESCALER 8
+#endif
+#if USI_UART_PRESCALER == 8
+#define USI_UART_CLOCK_SELECT _BV(CS01)
+#elif USI_UART_PRESCALER == 64
+#define USI_UART_CLOCK_SELECT (_BV(CS01)|_BV(CS00))
+#else
+#error "USI_UART_PRESCALER must be 8 or 64."
+#endif
+#define USI_UART_COMPARE_VALUE ((F_CPU / USI_UART_PRESCALER + USI_UART_BAUD_RATE / 2) / USI_UART_BAUD_RATE - 1) // OCR0A
+#define USI_UART_START_DELAY 5 // Counts of Timer/Counter0 from Start Bit to Set of TCNT0 in usi_uart_handler_start()
+#define USI_UART_RX_COUNT (1 + 8) // Start and Data Bits
+#define USI_UART_TX_COUNT_FIRST 8 // Start and Data Bits[6:0]
+#define USI_UART_TX_COUNT_SECOND (1 + USI_UART_STOP_BIT_NUMBER) // Data Bit[7] and Stop Bits
+#define USI_UART_USICR_SHIFT (_BV(USIOIE)|_BV(USIWM0)|_BV(USICS0)) // Three-wire Mode Clocked by Timer/Counter0 Compare Match
+#define USI_UART_STATUS_RX_BUSY_BIT (0b1 << 0)
+#define USI_UART_STATUS_RX_BUFFER_CHANGE_BIT (0b1 << 4) // Same as SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT
+#define USI_UART_STATUS_TX_BUSY_BIT (0b1 << 0)
+#define USI_UART_STATUS_TX_SECOND_BIT (0b1 << 1)
+#define USI_UART_STATUS_TX_PENDING_BIT (0b1 << 2)
+
+_Static_assert( USI_UART_COMPARE_VALUE <= 0xFF, "USI_UART_COMPARE_VALUE must fit in OCR0A, use a larger prescaler." );
+_Static_assert( USI_UART_STOP_BIT_NUMBER >= 1 && USI_UART_STOP_BIT_NUMBER <= 2, "USI_UART_STOP_BIT_NUMBER must be 1 or 2." );
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+volatile uint8_t usi_uart_tx_status;
+volatile uint8_t usi_uart_tx_byte;
+volatile uint8_t usi_uart_rx_status;
+volatile uint8_t usi_uart_rx_byte_buffer;
+
+// Reverse Bit Order
+static inline uint8_t usi_uart_reverse( uint8_t byte ) {
+	byte = (byte >> 4)|(byte << 4);
+	byte = ((byte & 0xCC) >> 2)|((byte & 0x33) << 2);
+	byte = ((byte & 0xAA) >> 1)|((byte & 0x55) << 1);
+	return byte;
+}
+
+// Wait for the Start Bit
+static inline void usi_uart_rx_wait() {
+	USICR = 0; // Stop USI
+	DDRB |= _BV(USI_UART_PIN_TX); // Output PORTB1 (High)
+	GIFR = _BV(PCIF); // Clear Flag of Edges during Tx or Data Bits
+	GIMSK |= _BV(PCIE);
+}
+
+static inline void usi_uart_tx_start() {
+	GIMSK &= ~(_BV(PCIE)); // Not to Detect Start Bit during Tx
+	USIDR = usi_uart_reverse( usi_uart_tx_byte ) >> 1; // Bit[7] Is Start Bit (Low)
+	USISR = _BV(USIOIF)|(16 - USI_UART_TX_COUNT_FIRST);
+	TCNT0 = 0; // Full Bit until the First Compare Match
+	USICR = USI_UART_USICR_SHIFT; // DO Outputs the Start Bit from Here
+	DDRB |= _BV(USI_UART_PIN_TX);
+	usi_uart_tx_status = USI_UART_STATUS_TX_BUSY_BIT;
+}
+
+static inline void usi_uart_init() {
+	usi_uart_tx_status = 0;
+	usi_uart_tx_byte = 0;
+	usi_uart_rx_status = 0;
+	usi_uart_rx_byte_buffer = 0;
+	PCMSK = _BV(PCINT0); // Pin Change Interrupt on DI
+	usi_uart_rx_wait();
+}
+
+static inline uint8_t usi_uart_tx_is_ready() {
+	return ! usi_uart_tx_status;
+}
+
+// Blocking Tx, Global Interrupt Must Be Enabled
+static inline void usi_uart_tx_put( uint8_t byte ) {
+	uint8_t sreg;
+	while ( ! usi_uart_tx_is_ready() );
+	sreg = SREG;
+	cli(); // Not to Start Rx between Check and Start of Tx
+	usi_uart_tx_byte = byte;
+	if ( usi_uart_rx_status & USI_UART_STATUS_RX_BUSY_BIT ) {
+		usi_uart_tx_status = USI_UART_STATUS_TX_PENDING_BIT;
+	} else {
+		usi_uart_tx_start();
+	}
+	SREG = sreg;
+}
+
+// Call in ISR(PCINT0_vect)
+static inline void usi_uart_handler_start() {
+	if ( PINB & _BV(USI_UART_PIN_RX) ) return; // Rising Edge
+	GIMSK &= ~(_BV(PCIE));
+	// First Compare Match at the Center of the Start Bit
+	TCNT0 = USI_UART_COMPARE_VALUE - ((USI_UART_COMPARE_VALUE + 1) >> 1) + USI_UART_START_DELAY;
+	USISR = _BV(USIOIF)|(16 - USI_UART_RX_COUNT);
+	DDRB &= ~(_BV(USI_UART_PIN_TX)); // DO Outputs Bits Shifted from DI in Three-wire Mode, Tx Is Pulled Up during Rx
+	USICR = USI_UART_USICR_SHIFT;
+	usi_uart_rx_status |= USI_UART_STATUS_RX_BUSY_BIT;
+}
+
+/**
+ * Call in ISR(USI_OVF_vect)
+ * handler_mode: Bit[1]: 0 = Normal, 1 = Loop Back after Data Bits of Rx (Same Bit as SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT)
+ */
+#define USI_UART_HANDLER_MODE_LOOP_BACK_BIT (0b1 << 1)
+static inline void usi_uart_handler_overflow( uint8_t handler_mode ) {
+	if ( usi_uart_tx_status & USI_UART_STATUS_TX_BUSY_BIT ) {
+		if ( ! (usi_uart_tx_status & USI_UART_STATUS_TX_SECOND_BIT) ) {
+			// DO Outputs a Bit Shifted from DI until This Point, Short Compared with a Bit
+			USIDR = (usi_uart_tx_byte & 0x80)|0x7F; // Data Bit[7] and Stop Bits, Remains High after Stop Bits
+			USISR = _BV(USIOIF)|(16 - USI_UART_TX_COUNT_SECOND);
+			usi_uart_tx_status |= USI_UART_STATUS_TX_SECOND_BIT;
+			return;
+		}
+		usi_uart_tx_status = 0;
+	} else {
+		// At the Center of Data Bit[7], USIBR Keeps the Value on Overflow
+		usi_uart_rx_byte_buffer = usi_uart_reverse( USIBR );
+		usi_uart_rx_status = (usi_uart_rx_status ^ USI_UART_STATUS_RX_BUFFER_CHANGE_BIT) & ~(USI_UART_STATUS_RX_BUSY_BIT);
+		if ( (handler_mode & USI_UART_HANDLER_MODE_LOOP_BACK_BIT) && ! usi_uart_tx_status ) {
+			usi_uart_tx_byte = usi_uart_rx_byte_buffer;
+			usi_uart_tx_status = USI_UART_STATUS_TX_PENDING_BIT;
+		}
+	}
+	USISR = _BV(USIOIF);
+	if ( usi_uart_tx_status & USI_UART_STATUS_TX_PENDING_BIT ) {
+		usi_uart_tx_start();
+	} else {
+		usi_uart_rx_wait();
+	}
+}
+
+/* Aliases of include_85/software_uart.h */
+
+#define SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT USI_UART_STATUS_RX_BUFFER_CHANGE_BIT
+#define SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT USI_UART_HANDLER_MODE_LOOP_BACK_BIT
+#define software_uart_rx_status usi_uart_rx_status
+#define software_uart_rx_byte_buffer usi_uart_rx_byte_buffer
+#define software_uart_tx_byte usi_uart_tx_byte // Don't Change during Tx
+#define software_uart_tx_count (usi_uart_tx_status + 0) // Read Only
+#define software_uart_tx_is_ready usi_uart_tx_is_ready
+#define software_uart_tx_put usi_uart_tx_put
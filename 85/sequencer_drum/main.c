@@ -12,8 +12,10 @@
 #include <avr/pgmspace.h>
 #include <util/delay.h>
 #include <util/delay_basic.h>
+#include "include/fixed_math.h"
 #include "sequencer.h"
 #include "include/random.h"
+#include "include_85/pwm_pll.h"
 
 #ifndef CALIB_OSCCAL
 #define CALIB_OSCCAL 0x00
@@ -28,8 +30,46 @@
  * Button 1: PB2 (Pulled Up), Start or Stop Sequence
  * Button 2: PB3 (Pulled Up), Change Output Level
  * Button 3: PB4 (Pulled Up), Change Beats per Second
+ * If SEQUENCER_PWM_PLL is 1, PWM Output is !OC1A (PB0) with the carrier of 250kHz (see include_85/pwm_pll.h).
+ * If SEQUENCER_LEVEL_MULTIPLY is 1, Button 2 changes the output level in -3dB steps by multiplying (see include/fixed_math.h).
+ *  ATtiny85 has no MUL instruction, and the multiply is the shift-add of approx. 60 clocks in the main loop, not in the ISR.
+ * If SEQUENCER_ENVELOPE is 1, each step with volume starts the ADSR envelope of the sequence, and each step without volume releases it (see include/envelope.h).
+ *  Noise keeps the last volume during release.
  */
 
+#define SEQUENCER_PWM_PLL 0 // 0 = Timer/Counter0 (31250Hz Carrier), 1 = Timer/Counter1 with PLL (250kHz Carrier)
+#if SEQUENCER_PWM_PLL
+#define SEQUENCER_OUTPUT(value) pwm_pll_set( value )
+#else
+#define SEQUENCER_OUTPUT(value) (OCR0A = (value))
+#endif
+
+#define SEQUENCER_LEVEL_MULTIPLY 0 // 0 = Halve Level by Shift (-6dB Steps), 1 = Multiply by Gain (-3dB Steps)
+#if SEQUENCER_LEVEL_MULTIPLY
+#define SEQUENCER_LEVEL_MAX (SEQUENCER_LEVEL_GAIN_NUMBER - 1)
+#define SEQUENCER_LEVEL(value,level) (fixed_math_mul_s8( value, pgm_read_byte(&(sequencer_level_gain_array[level])) ))
+#else
+#define SEQUENCER_LEVEL_MAX SEQUENCER_LEVEL_SHIFT_MAX
+#define SEQUENCER_LEVEL(value,level) ((value) >> (level))
+#endif
+
+#define SEQUENCER_ENVELOPE 0 // 0 = Steps Start and Stop Abruptly, 1 = ADSR Envelope at Approx. 1kHz
+#if SEQUENCER_ENVELOPE
+#define ENVELOPE_SAMPLE_RATE (F_CPU / 256)
+#include "include/envelope.h"
+#define SEQUENCER_SAMPLE(value) (fixed_math_mul_s8( value, envelope_level[0] ))
+#else
+#define SEQUENCER_SAMPLE(value) (value)
+#endif
+
+#if SEQUENCER_ENVELOPE
+// ADSR Envelope of Each Sequence: Attack, Decay, Sustain, Release (see include/envelope.h)
+uint8_t const sequencer_envelope_array[SEQUENCER_PROGRAM_LENGTH][ENVELOPE_PARAMETER_NUMBER] PROGMEM = { // Array in Program Space
+	{ 0, 10, 0x40, 7 }, // Sequence Index No. 0: Attack 1ms, Decay 32ms to 25%, Release 11ms
+	{ 2, 13, 0x00, 10 } // Sequence Index No. 1: Attack 2ms, Decay 85ms to Silence, Release 32ms
+};
+#endif
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -53,7 +93,8 @@ int main(void) {
 	int16_t button_2_sensitivity_count = SEQUENCER_BUTTON_SENSITIVITY;
 	int16_t button_3_sensitivity_count = SEQUENCER_BUTTON_SENSITIVITY;
 	uint8_t is_start_sequence = 0;
-	uint8_t level_shift = 0;
+	uint8_t level = 0;
+	int8_t sample = 0; // Sample before Envelope, Biased to Zero
 
 	/* Initialize Global Variables */
 	random_value = RANDOM_INIT;
@@ -63,6 +104,9 @@ int main(void) {
 	sequencer_interval_random = 0;
 	sequencer_interval_random_max = 0;
 	sequencer_next_random = 0;
+#if SEQUENCER_ENVELOPE
+	envelope_init();
+#endif
 
 	/* Clock Calibration */
 	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.0V
@@ -77,11 +121,18 @@ int main(void) {
 	TCNT0 = 0;
 	// Set Output Compare A
 	OCR0A = SEQUENCER_VOLTAGE_BIAS;
+#if SEQUENCER_PWM_PLL
+	pwm_pll_init( SEQUENCER_VOLTAGE_BIAS );
+#endif
 	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIMER0_OVF_vect)"
 	TIMSK = _BV(TOIE0);
 	// Select Fast PWM Mode (3) and Output from OC0A Non-inverted
 	// Fast PWM Mode (7) can make variable frequencies with adjustable duty cycle by settting OCR0A as TOP, but OC0B is only available.
+#if SEQUENCER_PWM_PLL
+	TCCR0A = _BV(WGM01)|_BV(WGM00); // No Output, Only Sample Rate
+#else
 	TCCR0A = _BV(WGM01)|_BV(WGM00)|_BV(COM0A1);
+#endif
 	// Start Counter with I/O-Clock 8.0MHz / ( 1 * 256 ) = 31250Hz
 	TCCR0B = _BV(CS00);
 
@@ -108,13 +159,21 @@ int main(void) {
 						sequencer_interval_random = 0;
 						sequencer_interval_random_max = 0;
 						count_last = 0;
+						sample = 0;
+#if SEQUENCER_ENVELOPE
+						envelope_init();
+#endif
 						TIFR |= _BV(TOV0); // Clear Set Timer/Counter0 Overflow Flag by Logic One
 						if ( ! (SREG & _BV(SREG_I)) ) sei(); // If Global Interrupt Enable Flag Is Not Set, Start to Issue Interrupt
 						is_start_sequence = 1;
 					} else {
 						cli(); // Stop to Issue Interrupt
-						OCR0A = SEQUENCER_VOLTAGE_BIAS;
+						SEQUENCER_OUTPUT( SEQUENCER_VOLTAGE_BIAS );
 						sequencer_next_random = 0;
+						sample = 0;
+#if SEQUENCER_ENVELOPE
+						envelope_is_update = 0; // Not to Output the Last Sample after Stop
+#endif
 						is_start_sequence = 0;
 					}
 				} // If Count Reaches -1, Do Nothing
@@ -129,20 +188,37 @@ int main(void) {
 			count_last = sequencer_count_update;
 			program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
 			sequencer_interval_random_max = pgm_read_word(&(sequencer_interval_random_max_array[program_byte & 0xF]));
+#if SEQUENCER_ENVELOPE
+			if ( program_byte & 0x70 ) {
+				volume_mask = pgm_read_byte(&(sequencer_volume_mask_array[(program_byte & 0x70) >> 4]));
+				volume_offset = pgm_read_byte(&(sequencer_volume_offset_array[(program_byte & 0x70) >> 4]));
+				envelope_note_on( 0, sequencer_envelope_array[program_index] );
+			} else {
+				envelope_note_off( 0 );
+			}
+#else
 			volume_mask = pgm_read_byte(&(sequencer_volume_mask_array[(program_byte & 0x70) >> 4]));
 			volume_offset = pgm_read_byte(&(sequencer_volume_offset_array[(program_byte & 0x70) >> 4]));
+#endif
 			random_high_resolution = program_byte & 0x80;
 		}
 		if ( sequencer_next_random ) {
 			random_make( random_high_resolution );
-			OCR0A = (uint8_t)((((int16_t)(((uint8_t)(random_high_resolution ? random_value : random_value << 1) & volume_mask) + volume_offset) - SEQUENCER_VOLTAGE_BIAS) >> level_shift) + SEQUENCER_VOLTAGE_BIAS);
+			sample = SEQUENCER_LEVEL( (int8_t)((((uint8_t)(random_high_resolution ? random_value : random_value << 1) & volume_mask) + volume_offset) - SEQUENCER_VOLTAGE_BIAS), level );
+			SEQUENCER_OUTPUT( (uint8_t)(SEQUENCER_SAMPLE( sample ) + SEQUENCER_VOLTAGE_BIAS) );
 			sequencer_next_random = 0;
 		}
+#if SEQUENCER_ENVELOPE
+		if ( envelope_is_update ) {
+			envelope_update();
+			SEQUENCER_OUTPUT( (uint8_t)(SEQUENCER_SAMPLE( sample ) + SEQUENCER_VOLTAGE_BIAS) );
+		}
+#endif
 		if ( (PINB ^ pin_button_2) & pin_button_2 ) { // If Match
 			if ( button_2_sensitivity_count >= 0 ) {
 				button_2_sensitivity_count--;
 				if ( button_2_sensitivity_count == 0 ) { // If Count Reaches Zero
-					if ( ++level_shift > SEQUENCER_LEVEL_SHIFT_MAX ) level_shift = 0;
+					if ( ++level > SEQUENCER_LEVEL_MAX ) level = 0;
 				} // If Count Reaches -1, Do Nothing
 			}
 		} else { // If Not Match
@@ -173,4 +249,7 @@ ISR(TIMER0_OVF_vect) {
 		sequencer_interval_random = 0;
 		sequencer_next_random = 1;
 	}
+#if SEQUENCER_ENVELOPE
+	envelope_handler_sample();
+#endif
 }
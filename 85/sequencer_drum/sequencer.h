@@ -11,6 +11,7 @@
 #define SEQUENCER_PROGRAM_COUNTUPTO 64
 #define SEQUENCER_PROGRAM_LENGTH 2 // Length of Sequence
 #define SEQUENCER_LEVEL_SHIFT_MAX 3
+#define SEQUENCER_LEVEL_GAIN_NUMBER 8
 #define SEQUENCER_INPUT_SENSITIVITY 250 // Less Number, More Sensitive (Except 0: Lowest Sensitivity)
 #define SEQUENCER_BUTTON_SENSITIVITY 2500 // Less Number, More Sensitive (Except 0: Lowest Sensitivity)
 
@@ -93,3 +94,15 @@ uint8_t const sequencer_program_array[SEQUENCER_PROGRAM_LENGTH][SEQUENCER_PROGRA
 	 0xF5,0xA5,0xF0,0xA0,0xF5,0xA5,0xF0,0xA0,0xF5,0xA5,0xF0,0xA0,0xF5,0xA5,0xF0,0xA0,
 	 0xF5,0xA5,0xF0,0xA0,0xF5,0xA5,0xF0,0xA0,0xF5,0xF0,0xF5,0xF0,0xF5,0xF0,0xF5,0xF0} // Sequence Index No. 1
 };
+
+// Gain of Output Level in Unsigned 0.8 Format, -3dB Steps
+uint8_t const sequencer_level_gain_array[SEQUENCER_LEVEL_GAIN_NUMBER] PROGMEM = { // Array in Program Space
+	0xFF, // 0dB (0.996)
+	0xB5, // -3dB
+	0x80, // -6dB
+	0x5A, // -9dB
+	0x40, // -12dB
+	0x2D, // -15dB
+	0x20, // -18dB
+	0x17 // -21dB
+};
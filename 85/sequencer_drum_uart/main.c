@@ -5,6 +5,17 @@
  */
 
 #define F_CPU 16000000UL // PLL 16.0Mhz to ATtiny85
+#define SEQUENCER_MIDI 0 // 0 = Bytes of Sequencer at 1200 Baud, 1 = MIDI at 31250 Baud
+#define SEQUENCER_PWM_PLL 0 // 0 = Timer/Counter0 (Approx. 31372.55Hz Carrier), 1 = Timer/Counter1 with PLL (250kHz Carrier)
+#if SEQUENCER_MIDI && SEQUENCER_PWM_PLL
+#error "SEQUENCER_MIDI needs Timer/Counter1 for the handler of software UART."
+#endif
+#if SEQUENCER_MIDI
+#define SOFTWARE_UART_BAUD_RATE 31250
+#define SOFTWARE_UART_INTERVAL_RX_FIRST 6 // 1.5 Bits
+#define SOFTWARE_UART_INTERVAL 4 // 125kHz Handler, Acceptable Error of Baud Rate Is Approx. 2.4% with Jitter (See Below)
+#define SOFTWARE_UART_CALIBRATION 0 // Bytes of MIDI Have No Fixed Interval, OSCCAL Is Loaded from EEPROM
+#endif
 #include <stdlib.h>
 #include <avr/io.h>
 #include <avr/cpufunc.h>
@@ -15,6 +26,12 @@
 #include "sequencer.h"
 #include "include/random.h"
 #include "include_85/software_uart.h"
+#include "include/telemetry.h"
+#define SEQUENCER_EEPROM_HANDLER_FREQUENCY (SOFTWARE_UART_BAUD_RATE * SOFTWARE_UART_INTERVAL) // Same as Handler of Software UART
+#include "include_85/sequencer_eeprom.h"
+#include "include_85/osccal_eeprom.h"
+#include "include_85/midi.h"
+#include "include_85/pwm_pll.h"
 
 #ifndef CALIB_OSCCAL
 #define CALIB_OSCCAL 0x00
@@ -31,8 +48,62 @@
  *  0x59 (Y): Start and Clock Sequence (2)
  *  0x50 (P): Stop and Reset Sequence
  *  Note: The set of Bit[3] starts a sequence, and the clear of Bit[3] stops a sequence. Bit[2:0] selects a sequence. Bit[7:4] indentifies a device group (in 4 groups).
+ *  0xC5: Upload Program to EEPROM, Sequence Index No. 2 to No. 7 (see include_85/sequencer_eeprom.h)
+ *  0xC3: Calibrate OSCCAL and Store to EEPROM (see include_85/osccal_eeprom.h)
+ *  Note: Bytes 0x40-0x7F are start and stop bytes of groups. Commands and their headers are out of the range, i.e., 0xC5 and 0xC3 are reserved.
+ *  Note: Bytes of the upload command are also looped back, so all devices in a chain get programs.
+ * If SEQUENCER_CUT_THROUGH is 1, Tx repeats each bit of Rx approx. 0.5 bit later (see include_85/software_uart.h).
+ *  Otherwise, Tx repeats a byte after the stop bit of Rx, and each device in a chain delays bytes approx. 8.3ms.
+ * If SEQUENCER_TELEMETRY is 1, Tx sends frames of TELEMETRY_TYPE_SEQUENCER with CRC-8 (see include/telemetry.h) at each step instead of repeating Rx.
+ *  Payload: Program Index, Step, Program Byte, OSCCAL
+ *  A frame (8 bytes) at 1200 baud takes approx. 66.7ms. A step is skipped to be reported if the previous frame is still being sent.
+ *  Note: Tx doesn't loop back, cut through, or send MIDI THRU, so the device must be the last one in a chain. Connect Tx to the host only.
+ *        The sync byte (0xA5) is out of group bytes, but the payload and CRC-8 can be 0x40-0x7F, which start or stop other devices.
+ */
+
+/**
+ * If SEQUENCER_MIDI is 1, Rx receives MIDI messages at 31250 baud (see include_85/midi.h), and Tx is MIDI THRU.
+ *  Timer1 runs at 125kHz (4 times of the baud rate), i.e., the handler is called every 128 clocks.
+ *  Worst case of ISR(TIMER1_OVF_vect) is approx. 112 clocks (counted from the instructions of the handler including the prologue and epilogue),
+ *  i.e., a data bit of Rx and a data bit of Tx (cut-through) in the same call. Other calls are approx. 55-60 clocks.
+ *  The load of CPU is approx. 45% while the line is idle and approx. 57% while bytes are received, added to approx. 10% of ISR(TIMER0_OVF_vect).
+ *  ISR(TIMER0_OVF_vect) enables interrupts at the start (ISR_NOBLOCK), so the jitter of the handler is approx. 10 clocks (2% of a bit) instead of its length.
+ *  Acceptable error of baud rate is approx. (50 - 25 - 2) / 9.5 = 2.4%. Rx of the upload and calibration commands is not used, and the timeout of the upload isn't called.
+ *  0xFA (Start): Start the sequence at the next clock
+ *  0xFB (Continue): Continue the sequence from the current step
+ *  0xFC (Stop): Stop the sequence
+ *  0xF8 (Clock): Advance the step every SEQUENCER_MIDI_CLOCK_DIVISOR clocks, e.g., 6 clocks (24 clocks per quarter note) for 16th notes
+ *  Note On of SEQUENCER_MIDI_NOTE_BASE + 0 to 7: Select and start the sequence of the index from the first step
+ *  Note Off of the selected note: Stop the sequence
+ */
+
+#define SEQUENCER_MIDI_CHANNEL 9 // MIDI Channel 10 (Drums), or MIDI_CHANNEL_OMNI
+#define SEQUENCER_MIDI_NOTE_BASE 36 // C1, Bass Drum 1 in General MIDI
+#define SEQUENCER_MIDI_CLOCK_DIVISOR 6
+/**
+ * If SEQUENCER_PWM_PLL is 1, PWM Output is !OC1A (PB0) with the carrier of 250kHz (see include_85/pwm_pll.h), and PB1 is not output.
+ *  The handler of software UART is called in ISR(TIMER0_OVF_vect) every 832 / 255 overflows on average, i.e., 16.0MHz / 1664 = Approx. 9615.38Hz,
+ *  the same as Timer/Counter1 without PLL PWM. Calls have jitter of a sample (approx. 3.8% of a bit at 1200 baud), and acceptable error of baud rate is approx. 3.4%.
  */
 
+#define SEQUENCER_UART_DIVIDER_NUMERATOR 255 // Approx. 31372.55Hz (16.0MHz / 510) to Approx. 9615.38Hz (16.0MHz / 1664), 510 / 1664 = 255 / 832
+#define SEQUENCER_UART_DIVIDER_DENOMINATOR 832
+#if SEQUENCER_PWM_PLL
+#define SEQUENCER_OUTPUT(value) pwm_pll_set( value )
+#else
+#define SEQUENCER_OUTPUT(value) (OCR0A = (value))
+#endif
+#define SEQUENCER_CUT_THROUGH 1 // 0 = Loop Back after Stop Bit, 1 = Cut-through
+#define SEQUENCER_TELEMETRY 0 // 0 = Tx Repeats Rx, 1 = Send Status Frame
+#define SEQUENCER_TELEMETRY_LENGTH 4 // Length of Payload
+#if SEQUENCER_TELEMETRY
+#define SEQUENCER_UART_MODE 0 // Tx Is Used for Frames
+#elif SEQUENCER_CUT_THROUGH
+#define SEQUENCER_UART_MODE SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT
+#else
+#define SEQUENCER_UART_MODE SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT
+#endif
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -44,7 +115,18 @@ int main(void) {
 	uint8_t program_byte;
 	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
 	uint8_t uart_status_buffer_change_last = 0;
+	uint8_t uart_byte;
 	uint8_t uart_byte_last = 0;
+#if SEQUENCER_MIDI
+	uint8_t midi_clock_count = 0;
+	uint8_t midi_is_armed = 0; // Start at the Next Clock
+#endif
+#if SEQUENCER_TELEMETRY
+	uint8_t telemetry_payload[SEQUENCER_TELEMETRY_LENGTH];
+	uint8_t telemetry_frame[SEQUENCER_TELEMETRY_LENGTH + 4];
+	uint8_t telemetry_frame_length = 0;
+	uint8_t telemetry_frame_index = 0;
+#endif
 
 	/* Initialize Global Variables */
 	random_value = RANDOM_INIT;
@@ -54,10 +136,16 @@ int main(void) {
 	sequencer_next_random = 0;
 	sequencer_is_start = 0;
 	software_uart_init();
+	sequencer_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
+	osccal_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
+#if SEQUENCER_MIDI
+	midi_init( SEQUENCER_MIDI_CHANNEL );
+#endif
 
 	/* Clock Calibration */
 	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
-	OSCCAL = osccal_default;
+	osccal_default = osccal_eeprom_load( osccal_default ); // Tuned Value in EEPROM If Stored
+	osccal_eeprom_set( osccal_default );
 
 	/* PLL On */
 	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
@@ -67,7 +155,11 @@ int main(void) {
 	PLLCSR |= _BV(PCKE);
 
 	/* I/O Settings */
+#if SEQUENCER_PWM_PLL
+	DDRB = _BV(DDB3)|_BV(DDB2)|_BV(DDB0); // PB1 Is OC1A
+#else
 	DDRB = _BV(DDB3)|_BV(DDB2)|_BV(DDB1)|_BV(DDB0);
+#endif
 	// To Do: Turn On Transceiver at This Point with Decent Delay
 	PORTB = _BV(PB4)|_BV(PB3); // Software UART Rx (PB4) Pullup (There is No Internal Pulldown), and Software UART Tx (PB3) High
 
@@ -76,29 +168,96 @@ int main(void) {
 	TCNT0 = 0;
 	// Timer/Counter0: Set Output Compare A
 	OCR0A = SEQUENCER_VOLTAGE_BIAS;
+#if SEQUENCER_PWM_PLL
+	sequencer_uart_divider = 0;
+	// Timer/Counter1: Start PWM with PLL Clock 64.0MHz / 256 = 250kHz
+	pwm_pll_init( SEQUENCER_VOLTAGE_BIAS );
+	// Set Timer/Counter0 Overflow Interrupt for "ISR(TIMER0_OVF_vect)"
+	TIMSK = _BV(TOIE0);
+	// Timer/Counter0: Select Phase Correct PWM Mode (1) without Output, Only Sample Rate
+	TCCR0A = _BV(WGM00);
+#else
 	// Timer/Counter1: Counter Reset
 	TCNT1 = 0;
 	// Timer/Counter1: Set Output Compare A
 	OCR1A = 0;
 	// Timer/Counter1: Set Output Compare C
+#if SEQUENCER_MIDI
+	OCR1C = 0x7F; // Decimal 127
+#else
 	OCR1C = 0xCF; // Decimal 207
+#endif
 	// Set Timer/Counter1 Overflow Interrupt for "ISR(TIMER1_OVF_vect)" and Timer/Counter0 Overflow Interrupt for "ISR(TIMER0_OVF_vect)"
 	TIMSK = _BV(TOIE1)|_BV(TOIE0);
 	// Timer/Counter0: Select Phase Correct PWM Mode (1) and Output from OC0A Non-inverted
 	// Timer/Counter0: Phase Correct Mode (5) can make variable frequencies with adjustable duty cycle by settting OCR0A as TOP, but OC0B is only available.
 	TCCR0A = _BV(WGM00)|_BV(COM0A1);
+#endif
 	// Start Counter with I/O-Clock 16.0MHz / ( 1 * 510 ) = Approx. 31372.55Hz
 	TCCR0B = _BV(CS00);
+#if SEQUENCER_MIDI
+	// Timer/Counter1: Start Counter with PLL Clock (64.0MHz / 4) / 128 (OCR1C + 1) = 125000Hz
+	TCCR1 = _BV(PWM1A)|_BV(CS11)|_BV(CS10);
+#elif ! SEQUENCER_PWM_PLL
 	// Timer/Counter1: Start Counter with PLL Clock (64.0MHz / 32) / 208 (OCR1C + 1) = Approx. 9615.38Hz
 	TCCR1 = _BV(PWM1A)|_BV(CS12)|_BV(CS11);
+#endif
 	sei(); // Start to Issue Interrupt
 
 	while(1) {
 		if ( uart_status_buffer_change_last != (software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) ) {
 			uart_status_buffer_change_last = software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
-			uart_byte_last = software_uart_rx_byte_buffer;
-			if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			uart_byte = software_uart_rx_byte_buffer;
+#if SEQUENCER_MIDI
+			// Make Bytes of Sequencer from MIDI Messages
+			switch ( midi_receive( uart_byte ) ) {
+				case MIDI_EVENT_CLOCK:
+					if ( midi_is_armed ) {
+						midi_is_armed = 0;
+						midi_clock_count = 0;
+						uart_byte_last = SEQUENCER_BYTE_GROUP_START_BIT|(uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK);
+						sequencer_is_start = 0; // Restart from First Step
+					} else if ( ++midi_clock_count >= SEQUENCER_MIDI_CLOCK_DIVISOR ) {
+						midi_clock_count = 0;
+						if ( sequencer_is_start ) sequencer_count_update++;
+					}
+					break;
+				case MIDI_EVENT_START:
+					midi_is_armed = 1;
+					break;
+				case MIDI_EVENT_CONTINUE:
+					uart_byte_last = SEQUENCER_BYTE_GROUP_START_BIT|(uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK);
+					sequencer_is_start = 1; // Not to Reset Step
+					break;
+				case MIDI_EVENT_STOP:
+					midi_is_armed = 0;
+					uart_byte_last = SEQUENCER_BYTE_GROUP_BIT|(uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK);
+					break;
+				case MIDI_EVENT_NOTE_ON:
+					if ( (uint8_t)(midi_note - SEQUENCER_MIDI_NOTE_BASE) <= SEQUENCER_BYTE_PROGRAM_MASK ) {
+						midi_clock_count = 0;
+						uart_byte_last = SEQUENCER_BYTE_GROUP_START_BIT|(midi_note - SEQUENCER_MIDI_NOTE_BASE);
+						sequencer_is_start = 0; // Restart from First Step
+					}
+					break;
+				case MIDI_EVENT_NOTE_OFF:
+					if ( midi_note - SEQUENCER_MIDI_NOTE_BASE == (uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK) ) {
+						uart_byte_last = SEQUENCER_BYTE_GROUP_BIT|(uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK);
+					}
+					break;
+				default:
+					break;
+			}
+		}
+#else
+			if ( ! sequencer_eeprom_receive( uart_byte ) && ! osccal_eeprom_receive( uart_byte ) ) {
+				uart_byte_last = uart_byte;
+				if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			}
 		}
+		sequencer_eeprom_write_poll();
+		osccal_eeprom_poll();
+#endif
 		if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && ! sequencer_is_start ) {
 			random_value = RANDOM_INIT; // Reset Random Value
 			sequencer_count_update = 1;
@@ -108,7 +267,7 @@ int main(void) {
 			sequencer_is_start = 1;
 		} else if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_BIT) && sequencer_is_start ) {
 			sequencer_is_start = 0;
-			OCR0A = SEQUENCER_VOLTAGE_BIAS;
+			SEQUENCER_OUTPUT( SEQUENCER_VOLTAGE_BIAS );
 			sequencer_next_random = 0;
 		}
 		if ( sequencer_count_update != count_last ) {
@@ -118,33 +277,72 @@ int main(void) {
 			count_last = sequencer_count_update;
 			program_index = uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK;
 			// Prevent Memory Overflow
-			if ( program_index >= SEQUENCER_PROGRAM_LENGTH ) program_index = SEQUENCER_PROGRAM_LENGTH - 1;
+			if ( program_index >= SEQUENCER_EEPROM_PROGRAM_END ) program_index = SEQUENCER_EEPROM_PROGRAM_END - 1;
 			// Prevent Memory Overflow in Case That Doesn't Happen Logically
 			//if ( ! count_last ) count_last = 1;
-			program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+			if ( program_index < SEQUENCER_PROGRAM_LENGTH ) {
+				program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+			} else {
+				program_byte = sequencer_eeprom_read( program_index, count_last - 1 );
+			}
 			sequencer_interval_random_max = pgm_read_word(&(sequencer_interval_random_max_array[program_byte & 0xF]));
 			volume_mask = pgm_read_byte(&(sequencer_volume_mask_array[(program_byte & 0x70) >> 4]));
 			volume_offset = pgm_read_byte(&(sequencer_volume_offset_array[(program_byte & 0x70) >> 4]));
 			random_high_resolution = program_byte & 0x80;
+#if SEQUENCER_TELEMETRY
+			if ( telemetry_frame_index >= telemetry_frame_length ) {
+				telemetry_payload[0] = program_index;
+				telemetry_payload[1] = count_last;
+				telemetry_payload[2] = program_byte;
+				telemetry_payload[3] = OSCCAL;
+				telemetry_frame_length = telemetry_make( telemetry_frame, TELEMETRY_TYPE_SEQUENCER, telemetry_payload, SEQUENCER_TELEMETRY_LENGTH );
+				telemetry_frame_index = 0;
+			}
+#endif
+		}
+#if SEQUENCER_TELEMETRY
+		if ( (telemetry_frame_index < telemetry_frame_length) && software_uart_tx_is_ready() ) {
+			software_uart_tx_byte = telemetry_frame[telemetry_frame_index++];
+			software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
 		}
+#endif
 		if ( sequencer_next_random ) {
 			random_make( random_high_resolution );
-			OCR0A = ((uint8_t)(random_high_resolution ? random_value : random_value << 1) & volume_mask) + volume_offset;
+			SEQUENCER_OUTPUT( ((uint8_t)(random_high_resolution ? random_value : random_value << 1) & volume_mask) + volume_offset );
 			sequencer_next_random = 0;
 		}
 	}
 	return 0;
 }
 
+#if SEQUENCER_MIDI
+ISR(TIMER0_OVF_vect, ISR_NOBLOCK) { // ISR(TIMER1_OVF_vect) Can Interrupt
+#else
 ISR(TIMER0_OVF_vect) {
+#endif
 	if ( sequencer_is_start ) {
 		if ( ++sequencer_interval_random >= sequencer_interval_random_max ) {
 			sequencer_interval_random = 0;
 			sequencer_next_random = 1;
 		}
 	}
+#if SEQUENCER_PWM_PLL
+	sequencer_uart_divider += SEQUENCER_UART_DIVIDER_NUMERATOR;
+	if ( sequencer_uart_divider >= SEQUENCER_UART_DIVIDER_DENOMINATOR ) {
+		sequencer_uart_divider -= SEQUENCER_UART_DIVIDER_DENOMINATOR;
+		software_uart_handler_rx_tx( SEQUENCER_UART_MODE|osccal_eeprom_handler_mode );
+		sequencer_eeprom_handler_timeout();
+	}
+#endif
 }
 
+#if ! SEQUENCER_PWM_PLL
 ISR(TIMER1_OVF_vect) {
-	software_uart_handler_rx_tx( SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT );
+#if SEQUENCER_MIDI
+	software_uart_handler_rx_tx( SEQUENCER_UART_MODE );
+#else
+	software_uart_handler_rx_tx( SEQUENCER_UART_MODE|osccal_eeprom_handler_mode );
+	sequencer_eeprom_handler_timeout();
+#endif
 }
+#endif
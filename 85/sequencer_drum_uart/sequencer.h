@@ -20,6 +20,9 @@ volatile uint16_t sequencer_interval_random;
 volatile uint16_t sequencer_interval_random_max;
 volatile uint8_t sequencer_next_random;
 volatile uint8_t sequencer_is_start;
+#if SEQUENCER_PWM_PLL
+uint16_t sequencer_uart_divider; // Only in ISR(TIMER0_OVF_vect)
+#endif
 
 // Delay Time in Turns to Generate Next Random Value
 uint16_t const sequencer_interval_random_max_array[16] PROGMEM = { // Array in Program Space
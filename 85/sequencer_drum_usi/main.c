@@ -0,0 +1,180 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+#define F_CPU 16000000UL // PLL 16.0Mhz to ATtiny85
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+#include <util/delay_basic.h>
+#include "sequencer.h"
+#include "include/random.h"
+#include "include_85/usi_uart.h"
+#include "include/telemetry.h"
+#define SEQUENCER_EEPROM_HANDLER_FREQUENCY 31250 // Timer/Counter1 Overflow
+#include "include_85/sequencer_eeprom.h"
+
+#ifndef CALIB_OSCCAL
+#define CALIB_OSCCAL 0x00
+#warning "CALIB_OSCCAL is defined with the default value 0x00."
+#endif
+
+/**
+ * USI UART Rx (DI): PB0 (Pulled Up)
+ * USI UART Tx (DO): PB1 (Pulled Up during Rx)
+ * Reserved to Control Transceiver or Device: PB2 (Output with Low)
+ * Reserved to Control Transceiver or Device: PB3 (Output with Low)
+ * PWM Output (OC1B): PB4 (DC Biased)
+ *  Bytes are the same as 85/sequencer_drum_uart at 19200 baud (see include_85/usi_uart.h).
+ *  0x58 (X): Start and Clock Sequence (1)
+ *  0x59 (Y): Start and Clock Sequence (2)
+ *  0x50 (P): Stop and Reset Sequence
+ *  0xC5: Upload Program to EEPROM, Sequence Index No. 2 to No. 7 (see include_85/sequencer_eeprom.h)
+ *  Note: Bytes 0x40-0x7F are start and stop bytes of groups. Commands and their headers are out of the range, i.e., 0xC5 is reserved.
+ * Timer/Counter0 clocks USI, and Timer/Counter1 outputs PWM and counts samples.
+ * If SEQUENCER_LOOP_BACK is 1, Tx repeats a byte after data bits of Rx. USI is half duplex, and bytes received during Tx are lost.
+ *  Upload programs to devices in a chain at intervals of two frames or more, e.g., one byte per 1ms at 19200 baud.
+ */
+
+#define SEQUENCER_LOOP_BACK 1 // 0 = No Tx, 1 = Loop Back after Data Bits
+#if SEQUENCER_LOOP_BACK
+#define SEQUENCER_UART_MODE USI_UART_HANDLER_MODE_LOOP_BACK_BIT
+#else
+#define SEQUENCER_UART_MODE 0
+#endif
+
+int main(void) {
+
+	/* Declare and Define Local Constants and Variables */
+	uint8_t volume_mask = 0x00;
+	uint8_t volume_offset = SEQUENCER_VOLTAGE_BIAS;
+	uint8_t random_high_resolution = 0;
+	uint16_t count_last = 0;
+	uint8_t program_index = 0;
+	uint8_t program_byte;
+	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
+	uint8_t uart_status_buffer_change_last = 0;
+	uint8_t uart_byte;
+	uint8_t uart_byte_last = 0;
+
+	/* Initialize Global Variables */
+	random_value = RANDOM_INIT;
+	sequencer_count_update = 0;
+	sequencer_interval_random = 0;
+	sequencer_interval_random_max = 0;
+	sequencer_next_random = 0;
+	sequencer_is_start = 0;
+	sequencer_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
+
+	/* Clock Calibration */
+	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
+	OSCCAL = osccal_default;
+
+	/* PLL On */
+	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
+	do {
+		_delay_us(100);
+	} while ( ! (PLLCSR & _BV(PLOCK)) );
+	PLLCSR |= _BV(PCKE);
+
+	/* I/O Settings */
+	DDRB = _BV(DDB4)|_BV(DDB3)|_BV(DDB2)|_BV(DDB1);
+	// To Do: Turn On Transceiver at This Point with Decent Delay
+	PORTB = _BV(PB1)|_BV(PB0); // USI UART Tx (PB1) High, and USI UART Rx (PB0) Pullup (There is No Internal Pulldown)
+
+	/* Counters */
+	// Timer/Counter0: Counter Reset
+	TCNT0 = 0;
+	// Timer/Counter0: Set Output Compare A to Clock USI
+	OCR0A = USI_UART_COMPARE_VALUE;
+	// Timer/Counter1: Counter Reset
+	TCNT1 = 0;
+	// Timer/Counter1: Set Output Compare B
+	OCR1B = SEQUENCER_VOLTAGE_BIAS;
+	// Timer/Counter1: Set Output Compare C
+	OCR1C = 0xFF;
+	// Set Timer/Counter1 Overflow Interrupt for "ISR(TIMER1_OVF_vect)"
+	TIMSK = _BV(TOIE1);
+	// Timer/Counter1: Select PWM Mode of OC1B and Output from OC1B Non-inverted
+	GTCCR = _BV(PWM1B)|_BV(COM1B1);
+	// Timer/Counter0: Select CTC Mode (2)
+	TCCR0A = _BV(WGM01);
+	// Start Counter with I/O-Clock 16.0MHz / ( USI_UART_PRESCALER * (OCR0A + 1) ) = Approx. 19230.77Hz
+	TCCR0B = USI_UART_CLOCK_SELECT;
+	// Timer/Counter1: Start Counter with PLL Clock (64.0MHz / 8) / 256 (OCR1C + 1) = 31250Hz
+	TCCR1 = _BV(CS12);
+	// USI UART: Enable Pin Change Interrupt for "ISR(PCINT0_vect)" and Wait for Start Bit
+	usi_uart_init();
+	sei(); // Start to Issue Interrupt
+
+	while(1) {
+		if ( uart_status_buffer_change_last != (usi_uart_rx_status & USI_UART_STATUS_RX_BUFFER_CHANGE_BIT) ) {
+			uart_status_buffer_change_last = usi_uart_rx_status & USI_UART_STATUS_RX_BUFFER_CHANGE_BIT;
+			uart_byte = usi_uart_rx_byte_buffer;
+			if ( ! sequencer_eeprom_receive( uart_byte ) ) {
+				uart_byte_last = uart_byte;
+				if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			}
+		}
+		sequencer_eeprom_write_poll();
+		if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && ! sequencer_is_start ) {
+			random_value = RANDOM_INIT; // Reset Random Value
+			sequencer_count_update = 1;
+			sequencer_interval_random = 0;
+			sequencer_interval_random_max = 0;
+			count_last = 0;
+			sequencer_is_start = 1;
+		} else if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_BIT) && sequencer_is_start ) {
+			sequencer_is_start = 0;
+			OCR1B = SEQUENCER_VOLTAGE_BIAS;
+			sequencer_next_random = 0;
+		}
+		if ( sequencer_count_update != count_last ) {
+			if ( sequencer_count_update > SEQUENCER_PROGRAM_COUNTUPTO ) { // If Count Reaches Last
+				sequencer_count_update = 1;
+			}
+			count_last = sequencer_count_update;
+			program_index = uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK;
+			// Prevent Memory Overflow
+			if ( program_index >= SEQUENCER_EEPROM_PROGRAM_END ) program_index = SEQUENCER_EEPROM_PROGRAM_END - 1;
+			if ( program_index < SEQUENCER_PROGRAM_LENGTH ) {
+				program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+			} else {
+				program_byte = sequencer_eeprom_read( program_index, count_last - 1 );
+			}
+			sequencer_interval_random_max = pgm_read_word(&(sequencer_interval_random_max_array[program_byte & 0xF]));
+			volume_mask = pgm_read_byte(&(sequencer_volume_mask_array[(program_byte & 0x70) >> 4]));
+			volume_offset = pgm_read_byte(&(sequencer_volume_offset_array[(program_byte & 0x70) >> 4]));
+			random_high_resolution = program_byte & 0x80;
+		}
+		if ( sequencer_next_random ) {
+			random_make( random_high_resolution );
+			OCR1B = ((uint8_t)(random_high_resolution ? random_value : random_value << 1) & volume_mask) + volume_offset;
+			sequencer_next_random = 0;
+		}
+	}
+	return 0;
+}
+
+ISR(TIMER1_OVF_vect) {
+	if ( sequencer_is_start ) {
+		if ( ++sequencer_interval_random >= sequencer_interval_random_max ) {
+			sequencer_interval_random = 0;
+			sequencer_next_random = 1;
+		}
+	}
+	sequencer_eeprom_handler_timeout();
+}
+
+ISR(PCINT0_vect) {
+	usi_uart_handler_start();
+}
+
+ISR(USI_OVF_vect) {
+	usi_uart_handler_overflow( SEQUENCER_UART_MODE );
+}
@@ -14,6 +14,10 @@
 #include <util/delay_basic.h>
 #include "sequencer.h"
 #include "include_85/software_uart.h"
+#include "include/telemetry.h"
+#define SEQUENCER_EEPROM_HANDLER_FREQUENCY (SOFTWARE_UART_BAUD_RATE * SOFTWARE_UART_INTERVAL) // Same as Handler of Software UART
+#include "include_85/sequencer_eeprom.h"
+#include "include_85/osccal_eeprom.h"
 
 #ifndef CALIB_OSCCAL
 #define CALIB_OSCCAL 0x00
@@ -30,8 +34,19 @@
  *  0x59 (Y): Start and Clock Sequence (2)
  *  0x50 (P): Stop and Reset Sequence
  *  Note: The set of Bit[3] starts a sequence, and the clear of Bit[3] stops a sequence. Bit[2:0] selects a sequence. Bit[7:4] indentifies a device group (in 4 groups).
+ *  0xC5: Upload Program to EEPROM, Sequence Index No. 2 to No. 7 (see include_85/sequencer_eeprom.h)
+ *  0xC3: Calibrate OSCCAL and Store to EEPROM (see include_85/osccal_eeprom.h)
+ *  Note: Bytes 0x40-0x7F are start and stop bytes of groups. Commands and their headers are out of the range, i.e., 0xC5 and 0xC3 are reserved.
+ * If SEQUENCER_TELEMETRY is 1, Tx sends frames of TELEMETRY_TYPE_SEQUENCER with CRC-8 (see include/telemetry.h) instead of the program byte.
+ *  Payload: Program Index, Step, Program Byte, OSCCAL
+ *  A frame (8 bytes) at 1200 baud takes approx. 66.7ms. A step is skipped to be reported if the previous frame is still being sent.
+ *  Note: Don't connect Tx to Rx of other sequencers in a chain if SEQUENCER_TELEMETRY is 1, connect it to the host only.
+ *        The sync byte (0xA5) is out of group bytes, but the payload and CRC-8 can be 0x40-0x7F, which start or stop other devices.
  */
 
+#define SEQUENCER_TELEMETRY 0 // 0 = Send Program Byte, 1 = Send Status Frame
+#define SEQUENCER_TELEMETRY_LENGTH 4 // Length of Payload
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -39,17 +54,27 @@ int main(void) {
 	uint8_t program_index = 0;
 	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
 	uint8_t uart_status_buffer_change_last = 0;
+	uint8_t uart_byte;
 	uint8_t uart_byte_last = 0;
+#if SEQUENCER_TELEMETRY
+	uint8_t telemetry_payload[SEQUENCER_TELEMETRY_LENGTH];
+	uint8_t telemetry_frame[SEQUENCER_TELEMETRY_LENGTH + 4];
+	uint8_t telemetry_frame_length = 0;
+	uint8_t telemetry_frame_index = 0;
+#endif
 
 	/* Initialize Global Variables */
 	sequencer_count_update = 0;
 	sequencer_is_start = 0;
 	sequencer_program_byte = 0;
 	software_uart_init();
+	sequencer_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
+	osccal_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
 
 	/* Clock Calibration */
 	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
-	OSCCAL = osccal_default;
+	osccal_default = osccal_eeprom_load( osccal_default ); // Tuned Value in EEPROM If Stored
+	osccal_eeprom_set( osccal_default );
 
 	/* PLL On */
 	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
@@ -89,9 +114,14 @@ int main(void) {
 	while(1) {
 		if ( uart_status_buffer_change_last != (software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) ) {
 			uart_status_buffer_change_last = software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
-			uart_byte_last = software_uart_rx_byte_buffer;
-			if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			uart_byte = software_uart_rx_byte_buffer;
+			if ( ! sequencer_eeprom_receive( uart_byte ) && ! osccal_eeprom_receive( uart_byte ) ) {
+				uart_byte_last = uart_byte;
+				if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			}
 		}
+		sequencer_eeprom_write_poll();
+		osccal_eeprom_poll();
 		if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && ! sequencer_is_start ) {
 			sequencer_count_update = 1;
 			count_last = 0;
@@ -106,13 +136,34 @@ int main(void) {
 			count_last = sequencer_count_update;
 			program_index = uart_byte_last & SEQUENCER_BYTE_PROGRAM_MASK;
 			// Prevent Memory Overflow
-			if ( program_index >= SEQUENCER_PROGRAM_LENGTH ) program_index = SEQUENCER_PROGRAM_LENGTH - 1;
+			if ( program_index >= SEQUENCER_EEPROM_PROGRAM_END ) program_index = SEQUENCER_EEPROM_PROGRAM_END - 1;
 			// Prevent Memory Overflow in Case That Doesn't Happen Logically
 			//if ( ! count_last ) count_last = 1;
-			sequencer_program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+			if ( program_index < SEQUENCER_PROGRAM_LENGTH ) {
+				sequencer_program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+			} else {
+				sequencer_program_byte = sequencer_eeprom_read( program_index, count_last - 1 );
+			}
+#if SEQUENCER_TELEMETRY
+			if ( telemetry_frame_index >= telemetry_frame_length ) {
+				telemetry_payload[0] = program_index;
+				telemetry_payload[1] = count_last;
+				telemetry_payload[2] = sequencer_program_byte;
+				telemetry_payload[3] = OSCCAL;
+				telemetry_frame_length = telemetry_make( telemetry_frame, TELEMETRY_TYPE_SEQUENCER, telemetry_payload, SEQUENCER_TELEMETRY_LENGTH );
+				telemetry_frame_index = 0;
+			}
+#else
 			software_uart_tx_byte = sequencer_program_byte;
-			software_uart_tx_count = 9;
+			software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+#endif
 		}
+#if SEQUENCER_TELEMETRY
+		if ( (telemetry_frame_index < telemetry_frame_length) && software_uart_tx_is_ready() ) {
+			software_uart_tx_byte = telemetry_frame[telemetry_frame_index++];
+			software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+		}
+#endif
 	}
 	return 0;
 }
@@ -122,5 +173,6 @@ ISR(TIMER0_OVF_vect) {
 }
 
 ISR(TIMER1_OVF_vect) {
-	software_uart_handler_rx_tx( 0 );
+	software_uart_handler_rx_tx( osccal_eeprom_handler_mode );
+	sequencer_eeprom_handler_timeout();
 }
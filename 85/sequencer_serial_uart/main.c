@@ -14,6 +14,8 @@
 #include <util/delay_basic.h>
 #include "sequencer.h"
 #include "include_85/software_uart.h"
+#include "include/telemetry.h"
+#include "include_85/osccal_eeprom.h"
 
 #ifndef CALIB_OSCCAL
 #define CALIB_OSCCAL 0x00
@@ -30,8 +32,18 @@
  *  0x59 (Y): Start and Clock Sequence (2)
  *  0x50 (P): Stop and Reset Sequence
  *  Note: The set of Bit[3] starts a sequence, and the clear of Bit[3] stops a sequence. Bit[2:0] selects a sequence. Bit[7:4] indentifies a device group (in 4 groups).
+ *  0xC3: Calibrate OSCCAL and Store to EEPROM (see include_85/osccal_eeprom.h)
+ *  Note: Bytes 0x40-0x7F are start and stop bytes of groups. Commands and their headers are out of the range, i.e., 0xC3 is reserved.
+ * If SEQUENCER_TELEMETRY is 1, Tx sends frames of TELEMETRY_TYPE_SEQUENCER with CRC-8 (see include/telemetry.h) instead of the program byte.
+ *  Payload: Program Index, Step, Program Byte, OSCCAL
+ *  A frame (8 bytes) at 1200 baud takes approx. 66.7ms. A step is skipped to be reported if the previous frame is still being sent.
+ *  Note: Don't connect Tx to Rx of other sequencers in a chain if SEQUENCER_TELEMETRY is 1, connect it to the host only.
+ *        The sync byte (0xA5) is out of group bytes, but the payload and CRC-8 can be 0x40-0x7F, which start or stop other devices.
  */
 
+#define SEQUENCER_TELEMETRY 0 // 0 = Send Program Byte, 1 = Send Status Frame
+#define SEQUENCER_TELEMETRY_LENGTH 4 // Length of Payload
+
 int main(void) {
 
 	/* Declare and Define Local Constants and Variables */
@@ -39,17 +51,26 @@ int main(void) {
 	uint8_t program_index = 0;
 	uint8_t osccal_default; // Calibrated Default Value of OSCCAL
 	uint8_t uart_status_buffer_change_last = 0;
+	uint8_t uart_byte;
 	uint8_t uart_byte_last = 0;
+#if SEQUENCER_TELEMETRY
+	uint8_t telemetry_payload[SEQUENCER_TELEMETRY_LENGTH];
+	uint8_t telemetry_frame[SEQUENCER_TELEMETRY_LENGTH + 4];
+	uint8_t telemetry_frame_length = 0;
+	uint8_t telemetry_frame_index = 0;
+#endif
 
 	/* Initialize Global Variables */
 	sequencer_count_update = 0;
 	sequencer_is_start = 0;
 	sequencer_program_byte = 0;
 	software_uart_init();
+	osccal_eeprom_init( SEQUENCER_BYTE_GROUP_BIT );
 
 	/* Clock Calibration */
 	osccal_default = OSCCAL + CALIB_OSCCAL; // Frequency Calibration for Individual Difference at VCC = 3.3V
-	OSCCAL = osccal_default;
+	osccal_default = osccal_eeprom_load( osccal_default ); // Tuned Value in EEPROM If Stored
+	osccal_eeprom_set( osccal_default );
 
 	/* PLL On */
 	if ( ! (PLLCSR & _BV(PLLE)) ) PLLCSR |= _BV(PLLE);
@@ -88,9 +109,13 @@ int main(void) {
 	while(1) {
 		if ( uart_status_buffer_change_last != (software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) ) {
 			uart_status_buffer_change_last = software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
-			uart_byte_last = software_uart_rx_byte_buffer;
-			if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			uart_byte = software_uart_rx_byte_buffer;
+			if ( ! osccal_eeprom_receive( uart_byte ) ) {
+				uart_byte_last = uart_byte;
+				if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && sequencer_is_start ) sequencer_count_update++;
+			}
 		}
+		osccal_eeprom_poll();
 		if ( ((uart_byte_last & SEQUENCER_BYTE_GROUP_START_BIT) == SEQUENCER_BYTE_GROUP_START_BIT) && ! sequencer_is_start ) {
 			sequencer_count_update = 1;
 			count_last = 0;
@@ -110,9 +135,26 @@ int main(void) {
 			// Prevent Memory Overflow in Case That Doesn't Happen Logically
 			//if ( ! count_last ) count_last = 1;
 			sequencer_program_byte = pgm_read_byte(&(sequencer_program_array[program_index][count_last - 1]));
+#if SEQUENCER_TELEMETRY
+			if ( telemetry_frame_index >= telemetry_frame_length ) {
+				telemetry_payload[0] = program_index;
+				telemetry_payload[1] = count_last;
+				telemetry_payload[2] = sequencer_program_byte;
+				telemetry_payload[3] = OSCCAL;
+				telemetry_frame_length = telemetry_make( telemetry_frame, TELEMETRY_TYPE_SEQUENCER, telemetry_payload, SEQUENCER_TELEMETRY_LENGTH );
+				telemetry_frame_index = 0;
+			}
+#else
 			software_uart_tx_byte = sequencer_program_byte;
-			software_uart_tx_count = 9;
+			software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
+#endif
+		}
+#if SEQUENCER_TELEMETRY
+		if ( (telemetry_frame_index < telemetry_frame_length) && software_uart_tx_is_ready() ) {
+			software_uart_tx_byte = telemetry_frame[telemetry_frame_index++];
+			software_uart_tx_count = SOFTWARE_UART_TX_COUNT_START;
 		}
+#endif
 	}
 	return 0;
 }
@@ -122,5 +164,5 @@ ISR(TIMER0_OVF_vect) {
 }
 
 ISR(TIMER1_OVF_vect) {
-	software_uart_handler_rx_tx( 0 );
+	software_uart_handler_rx_tx( osccal_eeprom_handler_mode );
 }
@@ -0,0 +1,346 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Simulator of a Network of Sequencers with Software UART (85/include_85/software_uart.h) on Host
+ * Devices run the handler of the software UART with their own clocks, and handle received bytes as the main loop of
+ * 85/sequencer_drum_uart, 85/sequencer_pwm_uart, and 85/sequencer_serial_uart, i.e., the group byte starts, clocks, and stops the sequencer.
+ * Rx of a device is wired to the host (RS-485 bus) or to Tx of another device (daisy chain), with the delay of the line.
+ * The host sends bytes at SIM_UART_BYTE_RATE (80Hz) from an accurate clock, e.g., clock bytes of groups in turn.
+ *
+ * Usage: bus_sim config.txt [seconds] [track]
+ *  track: 1 = Track OSCCAL (SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT) in all devices, 0 = Fixed OSCCAL (Default)
+ *
+ * Config (one line per device, "#" starts a comment):
+ *  group_byte clock_error delay source repeat
+ *  e.g., "0x50 +1.5 2.0 host cut-through" or "0x60 -0.7 0.5 0 none"
+ *  group_byte: Group of the device (Bit[7:4])
+ *  clock_error: Error of the clock in percents
+ *  delay: Delay of the line to Rx in microseconds
+ *  source: "host" or the index of the device (from 0) to which Rx is wired
+ *  repeat: "none", "loop-back", or "cut-through"
+ * Config (host):
+ *  host byte ...: Bytes sent by the host in turn (up to BUS_SIM_HOST_MAX), the default is the clock byte (0x08 added) of each group.
+ *
+ * Report:
+ *  Tick Skew: Difference of times when devices in a group advance the step with the same byte from the host.
+ *  Latency: Time from the start bit of the host to the advance of the step.
+ *  Dropped/Changed: Bytes not received or received with wrong values.
+ *  Clock: The error of the clock at the end, and the time after which the clock stays within 0.5% (-: Not Converged).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/io.h>
+#include "sim_uart.h"
+#include "include_85/software_uart.h"
+#include "sim_uart_node.h"
+
+#define BUS_SIM_NODE_MAX 64
+#define BUS_SIM_HOST_MAX 16
+#define BUS_SIM_HISTORY 16 // Must Be Power of 2
+#define BUS_SIM_OSCCAL 0x60
+#define BUS_SIM_THRESHOLD 0.005
+#define BUS_SIM_MARGIN 0.5 // Seconds at the End to Ignore Bytes in Flight
+#define BUS_SIM_GROUP_MASK 0xF0
+#define BUS_SIM_START_BIT 0x08
+#define BUS_SIM_SOURCE_HOST -1
+#define BUS_SIM_REPEAT_NONE 0
+#define BUS_SIM_REPEAT_LOOP_BACK SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT
+#define BUS_SIM_REPEAT_CUT_THROUGH SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT
+
+typedef struct {
+	sim_uart_node uart;
+	uint8_t group;
+	int source;
+	double delay;
+	uint8_t mode;
+	double clock_error;
+	// History of Tx for Delayed Levels
+	double history_time[BUS_SIM_HISTORY];
+	uint8_t history_level[BUS_SIM_HISTORY];
+	uint8_t history_index;
+	// Sequencer
+	uint8_t buffer_change;
+	uint8_t is_start;
+	uint32_t byte_index; // Index of Next Expected Byte from the Host
+	uint32_t byte_received;
+	uint32_t byte_dropped;
+	uint32_t byte_changed;
+	double* time_tick; // Time of Tick by Index of Byte from the Host, Negative If Not Ticked
+	double time_converge;
+} bus_sim_node;
+
+static bus_sim_node bus_sim_nodes[BUS_SIM_NODE_MAX];
+static int bus_sim_node_length;
+static uint8_t bus_sim_host[BUS_SIM_HOST_MAX];
+static int bus_sim_host_length;
+
+static int bus_sim_config( char const* path ) {
+	FILE* file = fopen( path, "r" );
+	char line[256];
+	int line_number = 0;
+	if ( ! file ) {
+		perror( path );
+		return -1;
+	}
+	while ( fgets( line, sizeof( line ), file ) ) {
+		char source[32];
+		char repeat[32];
+		unsigned int group;
+		double error;
+		double delay;
+		char* comment = strchr( line, '#' );
+		line_number++;
+		if ( comment ) *comment = '\0';
+		if ( strspn( line, " \t\r\n" ) == strlen( line ) ) continue;
+		if ( ! strncmp( line, "host", 4 ) ) {
+			char* token = strtok( line + 4, " \t\r\n" );
+			while ( token && bus_sim_host_length < BUS_SIM_HOST_MAX ) {
+				bus_sim_host[bus_sim_host_length++] = (uint8_t)strtoul( token, NULL, 0 );
+				token = strtok( NULL, " \t\r\n" );
+			}
+			continue;
+		}
+		if ( bus_sim_node_length >= BUS_SIM_NODE_MAX || sscanf( line, "%i %lf %lf %31s %31s", &group, &error, &delay, source, repeat ) != 5 ) {
+			fprintf( stderr, "%s:%d: Invalid device.\n", path, line_number );
+			fclose( file );
+			return -1;
+		}
+		bus_sim_node* node = &bus_sim_nodes[bus_sim_node_length];
+		node->group = group & BUS_SIM_GROUP_MASK;
+		node->clock_error = error / 100.0;
+		node->delay = delay / 1000000.0;
+		node->source = strcmp( source, "host" ) ? atoi( source ) : BUS_SIM_SOURCE_HOST;
+		if ( ! strcmp( repeat, "cut-through" ) ) {
+			node->mode = BUS_SIM_REPEAT_CUT_THROUGH;
+		} else if ( ! strcmp( repeat, "loop-back" ) ) {
+			node->mode = BUS_SIM_REPEAT_LOOP_BACK;
+		} else {
+			node->mode = BUS_SIM_REPEAT_NONE;
+		}
+		if ( node->source >= bus_sim_node_length ) {
+			fprintf( stderr, "%s:%d: Source must be the host or a previous device.\n", path, line_number );
+			fclose( file );
+			return -1;
+		}
+		bus_sim_node_length++;
+	}
+	fclose( file );
+	if ( ! bus_sim_node_length ) {
+		fprintf( stderr, "%s: No device.\n", path );
+		return -1;
+	}
+	// Default: Clock Byte of Each Group in Turn
+	if ( ! bus_sim_host_length ) {
+		for ( int i = 0; i < bus_sim_node_length; i++ ) {
+			int j;
+			for ( j = 0; j < bus_sim_host_length; j++ ) if ( bus_sim_host[j] == (bus_sim_nodes[i].group|BUS_SIM_START_BIT) ) break;
+			if ( j == bus_sim_host_length && bus_sim_host_length < BUS_SIM_HOST_MAX ) bus_sim_host[bus_sim_host_length++] = bus_sim_nodes[i].group|BUS_SIM_START_BIT;
+		}
+	}
+	return 0;
+}
+
+static uint8_t bus_sim_level_tx( bus_sim_node const* node, double time ) {
+	for ( int i = 0; i < BUS_SIM_HISTORY; i++ ) {
+		uint8_t index = (node->history_index - i) & (BUS_SIM_HISTORY - 1);
+		if ( node->history_time[index] <= time ) return node->history_level[index];
+	}
+	return 1;
+}
+
+// Handle a byte as the main loop of sequencers, and return true (not zero) if the step is advanced.
+static uint8_t bus_sim_sequencer( bus_sim_node* node, uint8_t byte ) {
+	if ( (byte & (BUS_SIM_GROUP_MASK|BUS_SIM_START_BIT)) == (node->group|BUS_SIM_START_BIT) ) {
+		node->is_start = 1; // Start or Clock
+		return 1;
+	} else if ( (byte & (BUS_SIM_GROUP_MASK|BUS_SIM_START_BIT)) == node->group ) {
+		node->is_start = 0;
+	}
+	return 0;
+}
+
+// Match a received byte with bytes from the host, and count dropped or changed bytes.
+static int32_t bus_sim_match( bus_sim_node* node, uint8_t const* bytes, uint32_t byte_sent, uint8_t byte ) {
+	int32_t index;
+	node->byte_received++;
+	if ( node->byte_index >= byte_sent ) {
+		node->byte_changed++;
+		return -1;
+	}
+	if ( byte != bytes[node->byte_index] && node->byte_index + 1 < byte_sent && byte == bytes[node->byte_index + 1] ) {
+		node->byte_dropped++;
+		node->byte_index++;
+	}
+	index = node->byte_index++;
+	if ( byte != bytes[index] ) {
+		node->byte_changed++;
+		return -1;
+	}
+	return index;
+}
+
+int main( int argc, char** argv ) {
+	sim_uart_line line;
+	uint32_t random = 1;
+	double seconds = (argc > 2) ? atof( argv[2] ) : 10.0;
+	uint8_t mode_track = (argc > 3 && atoi( argv[3] )) ? SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT : 0;
+	uint32_t byte_max = (uint32_t)(seconds * SIM_UART_BYTE_RATE) + 2;
+	uint32_t byte_sent = 0;
+	uint32_t byte_done;
+	uint8_t* bytes;
+	double* time_start;
+	double time_next = 0.005;
+	double time_sample = 0.0;
+	if ( argc < 2 || seconds <= BUS_SIM_MARGIN ) {
+		fprintf( stderr, "Usage: %s config.txt [seconds] [track]\n", argv[0] );
+		return 2;
+	}
+	if ( bus_sim_config( argv[1] ) ) return 2;
+	bytes = malloc( byte_max );
+	time_start = malloc( byte_max * sizeof( double ) );
+	sim_uart_line_init( &line, SOFTWARE_UART_BAUD_RATE, 0.0, 1 );
+	for ( int i = 0; i < bus_sim_node_length; i++ ) {
+		bus_sim_node* node = &bus_sim_nodes[i];
+		sim_uart_node_init( &node->uart, node->clock_error, BUS_SIM_OSCCAL, sim_uart_random( &random ) / 4294967296.0 );
+		for ( int j = 0; j < BUS_SIM_HISTORY; j++ ) {
+			node->history_time[j] = -1.0;
+			node->history_level[j] = 1;
+		}
+		node->time_tick = malloc( byte_max * sizeof( double ) );
+		for ( uint32_t j = 0; j < byte_max; j++ ) node->time_tick[j] = -1.0;
+		node->time_converge = (fabs( node->clock_error ) > BUS_SIM_THRESHOLD) ? -1.0 : 0.0;
+	}
+
+	while ( 1 ) {
+		int index = 0;
+		bus_sim_node* node;
+		double time;
+		uint8_t level_rx;
+		uint8_t level_tx_last;
+		for ( int i = 1; i < bus_sim_node_length; i++ ) {
+			if ( bus_sim_nodes[i].uart.time < bus_sim_nodes[index].uart.time ) index = i;
+		}
+		node = &bus_sim_nodes[index];
+		time = node->uart.time;
+		if ( time >= seconds ) break;
+		if ( time >= time_next && byte_sent < byte_max ) {
+			bytes[byte_sent] = bus_sim_host[byte_sent % bus_sim_host_length];
+			time_start[byte_sent] = time_next;
+			sim_uart_line_send( &line, time_next, bytes[byte_sent++] );
+			time_next += line.byte_interval;
+		}
+		if ( node->source == BUS_SIM_SOURCE_HOST ) {
+			level_rx = sim_uart_line_level( &line, time - node->delay );
+		} else {
+			level_rx = bus_sim_level_tx( &bus_sim_nodes[node->source], time - node->delay );
+		}
+		level_tx_last = sim_uart_node_level_tx( &node->uart );
+		sim_uart_node_step( &node->uart, level_rx, node->mode|mode_track );
+		if ( sim_uart_node_level_tx( &node->uart ) != level_tx_last ) {
+			node->history_index = (node->history_index + 1) & (BUS_SIM_HISTORY - 1);
+			node->history_time[node->history_index] = time;
+			node->history_level[node->history_index] = ! level_tx_last;
+		}
+		if ( (node->uart.rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) != node->buffer_change ) {
+			int32_t byte_index;
+			node->buffer_change = node->uart.rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
+			byte_index = bus_sim_match( node, bytes, byte_sent, node->uart.rx_byte_buffer );
+			if ( bus_sim_sequencer( node, node->uart.rx_byte_buffer ) && byte_index >= 0 ) node->time_tick[byte_index] = time;
+		}
+		if ( time >= time_sample ) {
+			time_sample += 0.1;
+			for ( int i = 0; i < bus_sim_node_length; i++ ) {
+				double error = 1.0 / (sim_uart_tick_period( &bus_sim_nodes[i].uart.clock, bus_sim_nodes[i].uart.osccal ) * SIM_UART_TICK_RATE) - 1.0;
+				if ( fabs( error ) > BUS_SIM_THRESHOLD ) {
+					bus_sim_nodes[i].time_converge = -1.0;
+				} else if ( bus_sim_nodes[i].time_converge < 0.0 ) {
+					bus_sim_nodes[i].time_converge = time;
+				}
+			}
+		}
+	}
+
+	byte_done = byte_sent;
+	// Bytes in Flight at the End Are Not Counted as Dropped or Missed
+	while ( byte_done && time_start[byte_done - 1] >= seconds - BUS_SIM_MARGIN ) byte_done--;
+
+	printf( "Devices (%.0f Seconds, %u Bytes from Host, OSCCAL %s)\n", seconds, byte_sent, mode_track ? "Tracked" : "Fixed" );
+	printf( "Index  Group  Source  Delay (us)  Clock Initial  Clock Final  Converged  Received  Dropped  Changed  Latency Mean/Max (ms)\n" );
+	for ( int i = 0; i < bus_sim_node_length; i++ ) {
+		bus_sim_node* node = &bus_sim_nodes[i];
+		double latency_sum = 0.0;
+		double latency_max = 0.0;
+		uint32_t count = 0;
+		char source[16];
+		char converge[16];
+		if ( byte_done > node->byte_index ) node->byte_dropped += byte_done - node->byte_index;
+		for ( uint32_t j = 0; j < byte_max; j++ ) {
+			if ( node->time_tick[j] < 0.0 ) continue;
+			double latency = node->time_tick[j] - time_start[j];
+			latency_sum += latency;
+			if ( latency > latency_max ) latency_max = latency;
+			count++;
+		}
+		if ( node->source == BUS_SIM_SOURCE_HOST ) {
+			snprintf( source, sizeof( source ), "host" );
+		} else {
+			snprintf( source, sizeof( source ), "%d", node->source );
+		}
+		if ( node->time_converge < 0.0 ) {
+			snprintf( converge, sizeof( converge ), "-" );
+		} else {
+			snprintf( converge, sizeof( converge ), "%.1fs", node->time_converge );
+		}
+		printf( "%5d   0x%02X  %6s  %10.1f  %+12.2f%%  %+10.2f%%  %9s  %8u  %7u  %7u  %8.2f/%.2f\n",
+			i, node->group, source, node->delay * 1000000.0, node->clock_error * 100.0,
+			(1.0 / (sim_uart_tick_period( &node->uart.clock, node->uart.osccal ) * SIM_UART_TICK_RATE) - 1.0) * 100.0,
+			converge, node->byte_received, node->byte_dropped, node->byte_changed,
+			count ? latency_sum / count * 1000.0 : 0.0, latency_max * 1000.0 );
+	}
+
+	printf( "\nGroups\n" );
+	printf( "Group  Devices  Ticks  Missed  Tick Skew Mean/Max (ms)\n" );
+	for ( int i = 0; i < bus_sim_node_length; i++ ) {
+		uint8_t group = bus_sim_nodes[i].group;
+		int devices = 0;
+		uint32_t ticks = 0;
+		uint32_t missed = 0;
+		double skew_sum = 0.0;
+		double skew_max = 0.0;
+		int j;
+		for ( j = 0; j < i; j++ ) if ( bus_sim_nodes[j].group == group ) break;
+		if ( j < i ) continue; // Reported
+		for ( j = i; j < bus_sim_node_length; j++ ) if ( bus_sim_nodes[j].group == group ) devices++;
+		for ( uint32_t k = 0; k < byte_done; k++ ) {
+			double first = -1.0;
+			double last = -1.0;
+			if ( (bytes[k] & (BUS_SIM_GROUP_MASK|BUS_SIM_START_BIT)) != (group|BUS_SIM_START_BIT) ) continue;
+			ticks++;
+			for ( j = i; j < bus_sim_node_length; j++ ) {
+				double time = bus_sim_nodes[j].time_tick[k];
+				if ( bus_sim_nodes[j].group != group ) continue;
+				if ( time < 0.0 ) {
+					missed++;
+					continue;
+				}
+				if ( first < 0.0 || time < first ) first = time;
+				if ( time > last ) last = time;
+			}
+			if ( first >= 0.0 ) {
+				skew_sum += last - first;
+				if ( last - first > skew_max ) skew_max = last - first;
+			}
+		}
+		printf( " 0x%02X  %7d  %5u  %6u  %10.3f/%.3f\n", group, devices, ticks, missed, ticks ? skew_sum / ticks * 1000.0 : 0.0, skew_max * 1000.0 );
+	}
+	for ( int i = 0; i < bus_sim_node_length; i++ ) free( bus_sim_nodes[i].time_tick );
+	free( bytes );
+	free( time_start );
+	return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Benchmark of Latency on Daisy-chained Devices of Software UART (85/include_85/software_uart.h) on Host
+ * The host sends bytes at SIM_UART_BYTE_RATE (80Hz) to the first device, and each device repeats bytes to the next device,
+ * i.e., Tx of a device is wired to Rx of the next device as 85/sequencer_drum_uart. The last device is a sink to check bytes.
+ * Each device has a random error of the clock within the spread, and a random phase of the handler.
+ *
+ * Usage: chain_sim [seconds] [spread of clock errors in percents]
+ *  Latency: Time from the start bit of the host to the start bit of Tx of the last device in the chain.
+ *  Errors: Bytes lost or changed at the sink.
+ *  Mode: Loop back after the stop bit (SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT), or cut-through (SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include "sim_uart.h"
+#include "include_85/software_uart.h"
+#include "sim_uart_node.h"
+
+#define CHAIN_SIM_NODE_MAX 40
+#define CHAIN_SIM_OSCCAL 0x60
+#define CHAIN_SIM_MARGIN 0.5 // Seconds, Longer Than Latency of Loop Back in CHAIN_SIM_NODE_MAX Devices
+
+typedef struct {
+	double latency_mean;
+	double latency_max;
+	uint32_t byte_sent;
+	uint32_t byte_error;
+} chain_sim_result;
+
+static void chain_sim_run( uint8_t mode, int length, double spread, double seconds, chain_sim_result* result ) {
+	sim_uart_node nodes[CHAIN_SIM_NODE_MAX + 1]; // Last One Is Sink
+	sim_uart_line line;
+	uint32_t random = 1;
+	uint32_t byte_max = (uint32_t)(seconds * SIM_UART_BYTE_RATE) + 2;
+	double* time_start = malloc( byte_max * sizeof( double ) );
+	uint8_t* bytes = malloc( byte_max );
+	uint32_t count_tx = 0; // Start Bits of the Last Device
+	uint32_t count_rx = 0; // Bytes Received by the Sink
+	uint8_t buffer_change = 0;
+	double time_next = 0.005;
+	double latency_sum = 0.0;
+	sim_uart_line_init( &line, SOFTWARE_UART_BAUD_RATE, 0.0, 1 );
+	for ( int i = 0; i <= length; i++ ) {
+		double error = spread * (2.0 * (sim_uart_random( &random ) / 4294967296.0) - 1.0);
+		sim_uart_node_init( &nodes[i], error, CHAIN_SIM_OSCCAL, sim_uart_random( &random ) / 4294967296.0 );
+	}
+	result->latency_max = 0.0;
+	result->byte_sent = 0;
+	result->byte_error = 0;
+	while ( 1 ) {
+		int index = 0;
+		double time;
+		uint8_t level_rx;
+		uint8_t level_tx_last;
+		for ( int i = 1; i <= length; i++ ) {
+			if ( nodes[i].time < nodes[index].time ) index = i;
+		}
+		time = nodes[index].time;
+		if ( time >= seconds ) break;
+		if ( time >= time_next && result->byte_sent < byte_max ) {
+			bytes[result->byte_sent] = sim_uart_random( &random ) & 0xFF;
+			time_start[result->byte_sent] = time_next;
+			sim_uart_line_send( &line, time_next, bytes[result->byte_sent++] );
+			time_next += line.byte_interval;
+		}
+		level_rx = index ? sim_uart_node_level_tx( &nodes[index - 1] ) : sim_uart_line_level( &line, time );
+		level_tx_last = sim_uart_node_level_tx( &nodes[index] );
+		sim_uart_node_step( &nodes[index], level_rx, (index < length) ? mode : 0 );
+		if ( index == length - 1 && level_tx_last && ! sim_uart_node_level_tx( &nodes[index] ) && nodes[index].tx_count == SOFTWARE_UART_TX_COUNT_START - 1 ) {
+			if ( count_tx < result->byte_sent ) {
+				double latency = time - time_start[count_tx];
+				latency_sum += latency;
+				if ( latency > result->latency_max ) result->latency_max = latency;
+			}
+			count_tx++;
+		}
+		if ( index == length && (nodes[index].rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) != buffer_change ) {
+			buffer_change = nodes[index].rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
+			if ( count_rx < result->byte_sent && nodes[index].rx_byte_buffer != bytes[count_rx] ) result->byte_error++;
+			count_rx++;
+		}
+	}
+	// Bytes Sent in the Last CHAIN_SIM_MARGIN Seconds May Be in the Chain, Not Counted as Lost
+	while ( result->byte_sent && time_start[result->byte_sent - 1] >= seconds - CHAIN_SIM_MARGIN ) result->byte_sent--;
+	if ( count_rx < result->byte_sent ) result->byte_error += result->byte_sent - count_rx;
+	result->latency_mean = count_tx ? latency_sum / count_tx : 0.0;
+	free( time_start );
+	free( bytes );
+}
+
+int main( int argc, char** argv ) {
+	double seconds = (argc > 1) ? atof( argv[1] ) : 10.0;
+	double spread = (argc > 2) ? atof( argv[2] ) / 100.0 : 0.01;
+	int const lengths[] = { 1, 2, 5, 10, 20, 40 };
+	uint8_t const modes[] = { SOFTWARE_UART_HANDLER_RX_TX_MODE_LOOP_BACK_BIT, SOFTWARE_UART_HANDLER_RX_TX_MODE_CUT_THROUGH_BIT };
+	char const* const names[] = { "Loop Back", "Cut-through" };
+	chain_sim_result result;
+	if ( seconds <= CHAIN_SIM_MARGIN ) {
+		fprintf( stderr, "Usage: %s [seconds] [spread of clock errors in percents]\n", argv[0] );
+		return 1;
+	}
+	printf( "Latency to the Last Device (%.0f Seconds, Clock Errors within +-%.1f%%, %d Baud)\n", seconds, spread * 100.0, SOFTWARE_UART_BAUD_RATE );
+	printf( "Mode         Devices  Mean (ms)  Max (ms)  Per Device (ms)  Errors\n" );
+	for ( size_t m = 0; m < sizeof( modes ) / sizeof( modes[0] ); m++ ) {
+		for ( size_t l = 0; l < sizeof( lengths ) / sizeof( lengths[0] ); l++ ) {
+			chain_sim_run( modes[m], lengths[l], spread, seconds, &result );
+			printf( "%-11s  %7d  %9.2f  %8.2f  %15.3f  %u/%u\n", names[m], lengths[l], result.latency_mean * 1000.0, result.latency_max * 1000.0, result.latency_mean * 1000.0 / lengths[l], result.byte_error, result.byte_sent );
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Verify include/fixed_math.h on Host with All Combinations of 8-bit Operands
+ * The shift-add of avr2 is emulated instruction by instruction with the carry flag, and compared with the product.
+ * Functions built with C on host are compared with the rounding documented in the header.
+ * Returns 1 if any result is not matched.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "include/fixed_math.h"
+
+// Emulate Shift-add in fixed_math_mul_u8_u16() for avr2
+static uint16_t fixed_math_check_shift_add( uint8_t a, uint8_t b ) {
+	uint8_t high = 0; // clr
+	uint8_t low = b;
+	uint8_t carry = low & 0x1; // lsr
+	uint8_t carry_next;
+	low >>= 1;
+	for ( uint8_t i = 0; i < 8; i++ ) {
+		if ( carry ) { // brcc, add
+			carry = ((uint16_t)high + a) > 0xFF;
+			high += a;
+		}
+		carry_next = high & 0x1; // ror
+		high = (high >> 1)|(carry << 7);
+		carry = carry_next;
+		carry_next = low & 0x1; // ror
+		low = (low >> 1)|(carry << 7);
+		carry = carry_next;
+	}
+	return ((uint16_t)high << 8)|low;
+}
+
+// Floor of Signed Division by 256
+static int32_t fixed_math_check_floor( int32_t value ) {
+	return value >= 0 ? value / 256 : -((-value + 255) / 256);
+}
+
+int main() {
+	uint32_t errors = 0;
+	for ( uint16_t a = 0; a <= 0xFF; a++ ) {
+		for ( uint16_t b = 0; b <= 0xFF; b++ ) {
+			int32_t sum_signed = (int32_t)(int8_t)a + (int8_t)b;
+			uint8_t low = a < b ? a : b;
+			uint8_t high = a < b ? b : a;
+			if ( fixed_math_check_shift_add( a, b ) != a * b ) errors++;
+			if ( fixed_math_mul_u8( a, b ) != (a * b) >> 8 ) errors++;
+			if ( fixed_math_mul_s8( (int8_t)a, b ) != fixed_math_check_floor( (int8_t)a * (int32_t)b ) ) errors++;
+			if ( fixed_math_add_sat_u8( a, b ) != (a + b > 0xFF ? 0xFF : a + b) ) errors++;
+			if ( fixed_math_add_sat_s8( (int8_t)a, (int8_t)b ) != (sum_signed > 127 ? 127 : (sum_signed < -128 ? -128 : sum_signed)) ) errors++;
+			for ( uint16_t t = 0; t <= 0xFF; t += 0x11 ) {
+				uint8_t lerp = fixed_math_lerp_u8( a, b, t );
+				if ( lerp < low || lerp > high ) errors++;
+				if ( t == 0 && lerp != a ) errors++;
+			}
+		}
+	}
+	printf( "Fixed-point Math: %u Errors in 65536 Combinations\n", errors );
+	if ( errors ) printf( "Error: Results are not matched.\n" );
+	return errors != 0;
+}
@@ -0,0 +1,33 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Mock of I/O Registers to Build Shared Headers on Host
+ * Registers are plain variables. A simulator sets PINB before calling a handler, and reads PORTB and OSCCAL after that.
+ * Only one translation unit can include this header, because registers are defined (not declared) here.
+ */
+
+#include <stdint.h>
+
+#define _BV( bit ) (1 << (bit))
+
+volatile uint8_t PINB;
+volatile uint8_t PORTB;
+volatile uint8_t DDRB;
+volatile uint8_t OSCCAL;
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PINB0 0
+#define PINB1 1
+#define PINB2 2
+#define PINB3 3
+#define PINB4 4
+#define PINB5 5
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Benchmark of OSCCAL Calibration in Software UART (85/include_85/software_uart.h) on Host
+ * Compares the adjustment (SOFTWARE_UART_HANDLER_RX_TX_MODE_ADJUST_OSC_BIT) and the tracking (SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT)
+ * with initial errors of the clock from -10% to +10%, and optionally with a drift of the clock by temperature.
+ * The host sends bytes at SIM_UART_BYTE_RATE (80Hz) from an accurate clock. See sim_uart.h for the model of the clock.
+ *
+ * Usage: osccal_bench [seconds] [drift per minute in percents] > result.csv
+ * Output (CSV): mode, initial OSCCAL, initial error (%), time to converge (s, -1 = not converged), steady-state error (RMS %), final OSCCAL
+ *  Converged: The clock stays within 0.5% until the end. Steady-state error is from the second half of the time.
+ *  Initial OSCCAL 0x7C tests the range crossing of 0x7F and 0x80.
+ *
+ * Plot with gnuplot, e.g.:
+ *  set datafile separator ","; plot "result.csv" using 3:($1 == 1 ? $4 : 1/0) title "adjust", "" using 3:($1 == 2 ? $4 : 1/0) title "track"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include "sim_uart.h"
+#include "include_85/software_uart.h"
+
+#define OSCCAL_BENCH_THRESHOLD 0.005
+#define OSCCAL_BENCH_JITTER 0.05
+#define OSCCAL_BENCH_SAMPLE 0.1 // Seconds
+
+typedef struct {
+	double time_converge;
+	double error_steady;
+	uint8_t osccal_final;
+} osccal_bench_result;
+
+static void osccal_bench_run( uint8_t mode, uint8_t osccal_initial, double clock_error, double drift, double seconds, osccal_bench_result* result ) {
+	sim_uart_clock clock = { clock_error, osccal_initial };
+	sim_uart_line line;
+	uint32_t random = 1;
+	double time = 0.0;
+	double time_next = 0.005;
+	double time_sample = 0.0;
+	double error;
+	double sum_square = 0.0;
+	uint32_t count_square = 0;
+	sim_uart_line_init( &line, SOFTWARE_UART_BAUD_RATE, OSCCAL_BENCH_JITTER, 1 );
+	software_uart_init();
+	OSCCAL = osccal_initial;
+	PINB = _BV(SOFTWARE_UART_PIN_RX);
+	result->time_converge = -1.0;
+	while ( time < seconds ) {
+		if ( time >= time_next ) {
+			sim_uart_line_send( &line, time_next, sim_uart_random( &random ) & 0xFF );
+			time_next += line.byte_interval;
+		}
+		PINB = sim_uart_line_level( &line, time ) << SOFTWARE_UART_PIN_RX;
+		software_uart_handler_rx_tx( mode );
+		time += sim_uart_tick_period( &clock, OSCCAL );
+		if ( time >= time_sample ) {
+			time_sample += OSCCAL_BENCH_SAMPLE;
+			clock.clock_error = clock_error + drift * time;
+			error = 1.0 / (sim_uart_tick_period( &clock, OSCCAL ) * SIM_UART_TICK_RATE) - 1.0;
+			if ( fabs( error ) > OSCCAL_BENCH_THRESHOLD ) {
+				result->time_converge = -1.0;
+			} else if ( result->time_converge < 0.0 ) {
+				result->time_converge = time;
+			}
+			if ( time >= seconds / 2.0 ) {
+				sum_square += error * error;
+				count_square++;
+			}
+		}
+	}
+	result->error_steady = count_square ? sqrt( sum_square / count_square ) : 0.0;
+	result->osccal_final = OSCCAL;
+}
+
+int main( int argc, char** argv ) {
+	double seconds = (argc > 1) ? atof( argv[1] ) : 60.0;
+	double drift = (argc > 2) ? atof( argv[2] ) / 100.0 / 60.0 : 0.0;
+	uint8_t const modes[] = { SOFTWARE_UART_HANDLER_RX_TX_MODE_ADJUST_OSC_BIT, SOFTWARE_UART_HANDLER_RX_TX_MODE_TRACK_OSC_BIT };
+	uint8_t const osccals[] = { 0x60, 0x7C };
+	osccal_bench_result result;
+	if ( seconds <= 0.0 ) {
+		fprintf( stderr, "Usage: %s [seconds] [drift per minute in percents]\n", argv[0] );
+		return 1;
+	}
+	printf( "mode,osccal_initial,error_initial,time_converge,error_steady,osccal_final\n" );
+	for ( size_t m = 0; m < sizeof( modes ) / sizeof( modes[0] ); m++ ) {
+		for ( size_t o = 0; o < sizeof( osccals ) / sizeof( osccals[0] ); o++ ) {
+			for ( int e = -10; e <= 10; e++ ) {
+				osccal_bench_run( modes[m], osccals[o], e / 100.0, drift, seconds, &result );
+				printf( "%u,0x%02X,%+d,%.1f,%.3f,0x%02X\n", (unsigned)(m + 1), osccals[o], e, result.time_converge, result.error_steady * 100.0, result.osccal_final );
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Calibrator of OSCCAL of Sequencers on ATtiny85 (see 85/include_85/osccal_eeprom.h)
+ * Usage: osccal_calibrate group_byte [seconds] [byte] > /dev/ttyUSB0 (Set the baud rate with stty in advance)
+ *        e.g., osccal_calibrate 0x50 10
+ * Sends the calibration command, then sends the byte (0x00 by default) at OSCCAL_CALIBRATE_FREQUENCY for seconds (10 by default).
+ * The byte should not start or stop sequencers. Intervals are made from the absolute time to avoid accumulating errors.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#define OSCCAL_CALIBRATE_COMMAND 0xC3
+#define OSCCAL_CALIBRATE_FREQUENCY 80 // Hz, SOFTWARE_UART_FREQUENCY
+
+int main( int argc, char** argv ) {
+	struct timespec time_next;
+	uint8_t group_byte;
+	unsigned int seconds;
+	uint8_t byte;
+	if ( argc < 2 ) {
+		fprintf( stderr, "Usage: %s group_byte [seconds] [byte]\n", argv[0] );
+		return 2;
+	}
+	group_byte = (uint8_t)strtoul( argv[1], NULL, 0 );
+	seconds = (argc > 2) ? strtoul( argv[2], NULL, 0 ) : 10;
+	byte = (argc > 3) ? (uint8_t)strtoul( argv[3], NULL, 0 ) : 0x00;
+	putchar( OSCCAL_CALIBRATE_COMMAND );
+	putchar( group_byte >> 4 ); // Group Number Out of Start and Stop Bytes
+	fflush( stdout );
+	clock_gettime( CLOCK_MONOTONIC, &time_next );
+	for ( unsigned int i = 0; i < seconds * OSCCAL_CALIBRATE_FREQUENCY; i++ ) {
+		time_next.tv_nsec += 1000000000L / OSCCAL_CALIBRATE_FREQUENCY;
+		if ( time_next.tv_nsec >= 1000000000L ) {
+			time_next.tv_nsec -= 1000000000L;
+			time_next.tv_sec++;
+		}
+		clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &time_next, NULL );
+		putchar( byte );
+		fflush( stdout );
+	}
+	fprintf( stderr, "Sent %u bytes to calibrate group 0x%02X.\n", seconds * OSCCAL_CALIBRATE_FREQUENCY, group_byte );
+	return 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Verify periods of LFSRs in include/random.h on Host
+ * random_make() is iterated from RANDOM_INIT, and the period is counted after values enter the cycle.
+ * Returns 1 if a period is not matched with the documented one (127 cycles for 7-bit, 32767 cycles for 15-bit).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "include/random.h"
+
+#define RANDOM_PERIOD_WARM_UP 65536 // Enough to Shift Out Bits Above the Resolution
+
+static uint32_t random_period( uint8_t high_resolution ) {
+	uint16_t start;
+	uint32_t period = 0;
+	random_value = RANDOM_INIT;
+	for ( uint32_t i = 0; i < RANDOM_PERIOD_WARM_UP; i++ ) random_make( high_resolution );
+	start = random_value;
+	do {
+		random_make( high_resolution );
+		period++;
+	} while ( random_value != start && period <= 0x10000 );
+	return period;
+}
+
+int main() {
+	uint32_t period_low = random_period( 0 );
+	uint32_t period_high = random_period( 1 );
+	int is_error = period_low != 127 || period_high != 32767;
+	printf( "7-bit LFSR: %u Cycles (Expected 127)\n", period_low );
+	printf( "15-bit LFSR: %u Cycles (Expected 32767)\n", period_high );
+	if ( is_error ) printf( "Error: Periods are not matched.\n" );
+	return is_error;
+}
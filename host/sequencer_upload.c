@@ -0,0 +1,65 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Uploader of Programs to EEPROM of Sequencers on ATtiny85 (see 85/include_85/sequencer_eeprom.h)
+ * Usage: sequencer_upload group_byte program_index < program.txt > /dev/ttyUSB0 (Set the baud rate with stty in advance)
+ *        e.g., sequencer_upload 0x50 2 < program.txt
+ * program.txt has bytes of a program in hexadecimal or decimal separated by spaces, commas, or new lines.
+ * The program is divided into commands of SEQUENCER_UPLOAD_CHUNK bytes, and the uploader waits for writing EEPROM after each command.
+ * Bytes of a command are sent back to back, because the device discards the command after a gap of SEQUENCER_EEPROM_TIMEOUT (10ms).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "include/telemetry.h"
+
+#define SEQUENCER_UPLOAD_COMMAND 0xC5
+#define SEQUENCER_UPLOAD_COUNTUPTO 64 // Bytes per Program
+#define SEQUENCER_UPLOAD_CHUNK 16 // Bytes per Command
+#define SEQUENCER_UPLOAD_BAUD_RATE 1200
+#define SEQUENCER_UPLOAD_WRITE_US 4000 // Time to Write a Byte to EEPROM (3.4ms) with Margin
+
+int main( int argc, char** argv ) {
+	uint8_t program[SEQUENCER_UPLOAD_COUNTUPTO];
+	unsigned int length = 0;
+	unsigned int value;
+	uint8_t group_byte;
+	uint8_t program_index;
+	if ( argc < 3 ) {
+		fprintf( stderr, "Usage: %s group_byte program_index < program.txt\n", argv[0] );
+		return 2;
+	}
+	group_byte = (uint8_t)strtoul( argv[1], NULL, 0 );
+	program_index = (uint8_t)strtoul( argv[2], NULL, 0 );
+	while ( length < SEQUENCER_UPLOAD_COUNTUPTO && scanf( " %i ,", &value ) == 1 ) program[length++] = (uint8_t)value;
+	if ( ! length ) {
+		fprintf( stderr, "No byte in the program.\n" );
+		return 2;
+	}
+	for ( unsigned int offset = 0; offset < length; offset += SEQUENCER_UPLOAD_CHUNK ) {
+		uint8_t chunk = length - offset < SEQUENCER_UPLOAD_CHUNK ? length - offset : SEQUENCER_UPLOAD_CHUNK;
+		uint8_t crc;
+		crc = telemetry_crc8( telemetry_crc8( telemetry_crc8( 0, program_index ), offset ), chunk - 1 );
+		putchar( SEQUENCER_UPLOAD_COMMAND );
+		putchar( group_byte >> 4 ); // Group Number Out of Start and Stop Bytes
+		putchar( program_index );
+		putchar( offset );
+		putchar( chunk - 1 ); // Length - 1 Out of Start and Stop Bytes
+		for ( unsigned int i = 0; i < chunk; i++ ) {
+			putchar( program[offset + i] );
+			crc = telemetry_crc8( crc, program[offset + i] );
+		}
+		putchar( crc );
+		fflush( stdout );
+		// Wait for Transmission (10 Bits per Byte) and Writing EEPROM
+		usleep( (chunk + 6) * 10 * 1000000UL / SEQUENCER_UPLOAD_BAUD_RATE + chunk * SEQUENCER_UPLOAD_WRITE_US );
+	}
+	fprintf( stderr, "Uploaded %u bytes to program %u of group 0x%02X.\n", length, program_index, group_byte );
+	return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Models for Simulators of Software UART (85/include_85/software_uart.h) on Host
+ *
+ * Clock of ATtiny85: The handler is called at SIM_UART_TICK_RATE (PLL 64MHz / 32 / 208) multiplied by the clock error.
+ * One step of OSCCAL changes the clock by SIM_UART_OSCCAL_STEP (0.55%, see the comment in software_uart.h).
+ * OSCCAL has two overlapping ranges, Bit[7] selects the higher range which starts at the middle of the lower range,
+ * so 0x80 is approx. 0x40 in the lower range. Crossing 0x7F and 0x80 changes the clock by approx. 35%.
+ *
+ * Line: Bytes are sent at SIM_UART_BYTE_RATE (80Hz) from an accurate clock, as the host does.
+ * Each edge is shifted by Gaussian jitter, which is given as a ratio of the bit time.
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#define SIM_UART_TICK_RATE (64000000.0 / 32.0 / 208.0) // Approx. 9615.38Hz
+#define SIM_UART_OSCCAL_STEP 0.0055
+#define SIM_UART_OSCCAL_HIGH_OFFSET 64 // Steps of Lower Range at 0x80
+#define SIM_UART_BYTE_RATE 80.0
+#define SIM_UART_BITS 10 // Start, 8 Data, and Stop Bits
+
+typedef struct {
+	double clock_error; // Ratio, e.g., 0.03 = +3%
+	uint8_t osccal_reference; // OSCCAL at Which the Clock Error Is Measured
+} sim_uart_clock;
+
+typedef struct {
+	double baud_rate; // Baud Rate Including Error
+	double jitter; // Standard Deviation of Edge Jitter in Bit Time
+	double byte_interval;
+	double start; // Start Time of Current Byte
+	double edge[SIM_UART_BITS + 1]; // Edges of Current Byte
+	uint8_t byte;
+	uint32_t random;
+	uint32_t count;
+} sim_uart_line;
+
+static inline double sim_uart_osccal_steps( uint8_t osccal ) {
+	return (double)(osccal & 0x7F) + ((osccal & 0x80) ? SIM_UART_OSCCAL_HIGH_OFFSET : 0);
+}
+
+// Period of the handler at the current OSCCAL in seconds
+static inline double sim_uart_tick_period( sim_uart_clock const* clock, uint8_t osccal ) {
+	double steps = sim_uart_osccal_steps( osccal ) - sim_uart_osccal_steps( clock->osccal_reference );
+	return 1.0 / (SIM_UART_TICK_RATE * (1.0 + clock->clock_error) * (1.0 + SIM_UART_OSCCAL_STEP * steps));
+}
+
+static inline uint32_t sim_uart_random( uint32_t* state ) { // xorshift32
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static inline double sim_uart_gaussian( uint32_t* state ) { // Box-Muller
+	double u1 = (sim_uart_random( state ) + 1.0) / 4294967297.0;
+	double u2 = (sim_uart_random( state ) + 1.0) / 4294967297.0;
+	return sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * M_PI * u2 );
+}
+
+// Schedule a byte at the time, and return the time of the end of the stop bit.
+static inline double sim_uart_line_send( sim_uart_line* line, double time, uint8_t byte ) {
+	double bit_time = 1.0 / line->baud_rate;
+	line->start = time;
+	line->byte = byte;
+	for ( int i = 0; i <= SIM_UART_BITS; i++ ) {
+		double jitter = (i == 0) ? 0.0 : line->jitter * sim_uart_gaussian( &line->random );
+		if ( jitter > 0.45 ) jitter = 0.45;
+		if ( jitter < -0.45 ) jitter = -0.45;
+		line->edge[i] = time + (i + jitter) * bit_time;
+	}
+	line->count++;
+	return line->edge[SIM_UART_BITS];
+}
+
+static inline void sim_uart_line_init( sim_uart_line* line, double baud_rate, double jitter, uint32_t seed ) {
+	line->baud_rate = baud_rate;
+	line->jitter = jitter;
+	line->byte_interval = 1.0 / SIM_UART_BYTE_RATE;
+	line->random = seed ? seed : 1;
+	line->count = 0;
+	line->byte = 0xFF;
+	for ( int i = 0; i <= SIM_UART_BITS; i++ ) line->edge[i] = -1.0; // Idle
+}
+
+// Level of the line at the time, 1 = High (Idle)
+static inline uint8_t sim_uart_line_level( sim_uart_line const* line, double time ) {
+	if ( time < line->edge[0] || time >= line->edge[SIM_UART_BITS - 1] ) return 1; // Idle or Stop Bit
+	if ( time < line->edge[1] ) return 0; // Start Bit
+	for ( int i = 1; i < SIM_UART_BITS - 1; i++ ) {
+		if ( time < line->edge[i + 1] ) return (line->byte >> (i - 1)) & 0b1;
+	}
+	return 1;
+}
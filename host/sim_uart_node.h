@@ -0,0 +1,96 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Multiple Devices of Software UART (85/include_85/software_uart.h) on Host
+ * Include this file after "sim_uart.h" and "include_85/software_uart.h".
+ * Global variables of the header and mocked registers are saved to and loaded from each node,
+ * so a simulator can call software_uart_handler_rx_tx() for each device in order of time.
+ */
+
+typedef struct {
+	uint8_t tx_count;
+	uint8_t tx_interval_count;
+	uint8_t tx_byte;
+	uint8_t rx_status;
+	uint8_t rx_interval_count;
+	uint8_t rx_byte;
+	uint8_t rx_byte_buffer;
+	uint16_t freq_counter_handler_loop;
+	uint16_t freq_counter_byte;
+	uint8_t track_interval;
+	uint8_t track_count;
+	uint16_t track_sum;
+	uint8_t track_stable;
+	uint8_t pinb;
+	uint8_t portb;
+	uint8_t osccal;
+	sim_uart_clock clock;
+	double time; // Time of Next Call of the Handler
+} sim_uart_node;
+
+static inline void sim_uart_node_save( sim_uart_node* node ) {
+	node->tx_count = software_uart_tx_count;
+	node->tx_interval_count = software_uart_tx_interval_count;
+	node->tx_byte = software_uart_tx_byte;
+	node->rx_status = software_uart_rx_status;
+	node->rx_interval_count = software_uart_rx_interval_count;
+	node->rx_byte = software_uart_rx_byte;
+	node->rx_byte_buffer = software_uart_rx_byte_buffer;
+	node->freq_counter_handler_loop = software_uart_freq_counter_handler_loop;
+	node->freq_counter_byte = software_uart_freq_counter_byte;
+	node->track_interval = software_uart_track_interval;
+	node->track_count = software_uart_track_count;
+	node->track_sum = software_uart_track_sum;
+	node->track_stable = software_uart_track_stable;
+	node->pinb = PINB;
+	node->portb = PORTB;
+	node->osccal = OSCCAL;
+}
+
+static inline void sim_uart_node_load( sim_uart_node const* node ) {
+	software_uart_tx_count = node->tx_count;
+	software_uart_tx_interval_count = node->tx_interval_count;
+	software_uart_tx_byte = node->tx_byte;
+	software_uart_rx_status = node->rx_status;
+	software_uart_rx_interval_count = node->rx_interval_count;
+	software_uart_rx_byte = node->rx_byte;
+	software_uart_rx_byte_buffer = node->rx_byte_buffer;
+	software_uart_freq_counter_handler_loop = node->freq_counter_handler_loop;
+	software_uart_freq_counter_byte = node->freq_counter_byte;
+	software_uart_track_interval = node->track_interval;
+	software_uart_track_count = node->track_count;
+	software_uart_track_sum = node->track_sum;
+	software_uart_track_stable = node->track_stable;
+	PINB = node->pinb;
+	PORTB = node->portb;
+	OSCCAL = node->osccal;
+}
+
+// phase: Time of the first call in ratio of the period, 0.0 to 1.0
+static inline void sim_uart_node_init( sim_uart_node* node, double clock_error, uint8_t osccal, double phase ) {
+	software_uart_init();
+	PINB = _BV(SOFTWARE_UART_PIN_RX);
+	PORTB = _BV(SOFTWARE_UART_PIN_TX);
+	OSCCAL = osccal;
+	node->clock.clock_error = clock_error;
+	node->clock.osccal_reference = osccal;
+	node->time = phase * sim_uart_tick_period( &node->clock, osccal );
+	sim_uart_node_save( node );
+}
+
+// Call the handler with the level of Rx, and advance the time to the next call.
+static inline void sim_uart_node_step( sim_uart_node* node, uint8_t level_rx, uint8_t handler_rx_tx_mode ) {
+	sim_uart_node_load( node );
+	PINB = level_rx << SOFTWARE_UART_PIN_RX;
+	software_uart_handler_rx_tx( handler_rx_tx_mode );
+	sim_uart_node_save( node );
+	node->time += sim_uart_tick_period( &node->clock, node->osccal );
+}
+
+static inline uint8_t sim_uart_node_level_tx( sim_uart_node const* node ) {
+	return (node->portb >> SOFTWARE_UART_PIN_TX) & 0b1;
+}
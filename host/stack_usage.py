@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+##
+# Copyright 2021 Kenta Ishii
+# License: 3-Clause BSD License
+# SPDX Short Identifier: BSD-3-Clause
+##
+
+"""
+Static Analyzer of Stack Depth and SRAM Usage for AVR Images
+
+Usage: stack_usage.py --dump program.dump --size "data bss" [--su main.su ...] [--sram 64]
+
+The call graph is made from the disassembly (avr-objdump -D) of the ELF.
+The frame of each function is the larger of the frame in -fstack-usage (*.su),
+and the frame counted from the disassembly (push, "rcall .+0", and the subtraction of the Y pointer).
+Names in *.su don't have the number of clones, e.g., "foo.constprop" is "foo.constprop.0" in the disassembly.
+*.su is optional, e.g., ltrans of -flto in GCC 10 or before writes it to a temporary folder, then frames are only from the disassembly.
+Roots are main and interrupt vectors (__vector_N), and only functions reached from roots are analyzed.
+Jumps into the startup code of avr-libc (e.g., __vectors and __bad_interrupt which jump to each other) are not followed.
+An interrupt pushes the return address (2 bytes).
+Interrupts don't nest unless the interrupt handler has "sei", so the worst case is
+the depth of main plus the deepest interrupt, or plus all interrupts which enable nesting.
+The build fails (exit 1) if .data + .bss + the worst stack depth exceeds SRAM.
+Indirect calls (icall/ijmp) and recursion in reached functions can't be analyzed, and also fail the build.
+"""
+
+import argparse
+import re
+import sys
+
+RETURN_ADDRESS = 2 # 16-bit Program Counter on ATtiny13/85
+PROLOGUE_SAVES = 18 # Registers Pushed by __prologue_saves__ (-mcall-prologues) at Most
+
+# Startup Code of avr-libc, Not Called from Roots but Reached by Jumps, e.g., "rjmp __bad_interrupt" in __vectors
+STARTUP_SYMBOLS = ( '__vectors', '__bad_interrupt', '__ctors_start', '__ctors_end', '__dtors_start', '__dtors_end', '__init',
+	'__do_copy_data', '__do_clear_bss', '__do_global_ctors', '__do_global_dtors', '_exit', '__stop_program' )
+
+LINE_FUNCTION = re.compile(r'^([0-9a-f]+) <([^>]+)>:$')
+LINE_INSTRUCTION = re.compile(r'^\s*([0-9a-f]+):\s+(?:[0-9a-f]{2} )+\s*(\S+)\s*([^;]*)(?:;\s*0x[0-9a-f]+ <([^>+]+)(?:\+0x[0-9a-f]+)?>)?')
+
+def parse_dump( path ):
+	"""Return {name: [(mnemonic, operands, target), ...]} of functions in .text."""
+	functions = {}
+	instructions = None
+	is_text = False
+	with open( path ) as file:
+		for line in file:
+			line = line.rstrip( '\n' )
+			if line.startswith( 'Disassembly of section' ):
+				is_text = line.strip().endswith( '.text:' )
+				instructions = None
+				continue
+			if not is_text:
+				continue
+			match = LINE_FUNCTION.match( line )
+			if match:
+				instructions = functions.setdefault( match.group( 2 ), [] )
+				continue
+			match = LINE_INSTRUCTION.match( line )
+			if match and instructions is not None:
+				instructions.append( (match.group( 2 ), match.group( 3 ).strip(), match.group( 4 )) )
+	return functions
+
+def parse_su( paths ):
+	"""Return {name: bytes} from -fstack-usage files."""
+	frames = {}
+	for path in paths:
+		with open( path ) as file:
+			for line in file:
+				fields = line.split( '\t' )
+				if len( fields ) < 2:
+					continue
+				name = fields[0].split( ':' )[-1]
+				frames[name] = max( frames.get( name, 0 ), int( fields[1] ) )
+	return frames
+
+def immediate( operands ):
+	value = operands.split( ',' )[-1].strip()
+	try:
+		return int( value, 0 )
+	except ValueError:
+		return 0
+
+def frame_from_dump( instructions ):
+	"""Count bytes pushed in the prologue of a function."""
+	frame = 0
+	last_r26 = 0
+	last_r27 = 0
+	is_stack_pointer_set = False # Subtraction of Y after Setting SPL Is Epilogue
+	for mnemonic, operands, target in instructions:
+		if mnemonic == 'push':
+			frame += 1
+		elif mnemonic == 'rcall' and operands.startswith( '.+0' ):
+			frame += RETURN_ADDRESS # Allocation of 2 Bytes
+		elif mnemonic in ( 'sbiw', 'subi' ) and operands.startswith( 'r28' ) and not is_stack_pointer_set:
+			frame += immediate( operands )
+		elif mnemonic == 'out' and operands.replace( ' ', '' ) == '0x3d,r28':
+			is_stack_pointer_set = True
+		elif mnemonic == 'ldi' and operands.startswith( 'r26' ):
+			last_r26 = immediate( operands )
+		elif mnemonic == 'ldi' and operands.startswith( 'r27' ):
+			last_r27 = immediate( operands )
+		elif mnemonic in ( 'rjmp', 'jmp' ) and target == '__prologue_saves__':
+			frame += PROLOGUE_SAVES + (last_r27 << 8 | last_r26)
+	return frame
+
+def analyze( functions, frames, roots ):
+	"""Return {name: depth} of roots and functions reached from them, and errors. Depth includes the frame of the function and callees."""
+	depths = {}
+	errors = []
+	visiting = set()
+	def depth( name ):
+		if name in depths:
+			return depths[name]
+		if name in visiting:
+			errors.append( 'Recursion in %s' % name )
+			return 0
+		visiting.add( name )
+		instructions = functions.get( name, [] )
+		frame = max( frames.get( name, frames.get( re.sub( r'\.\d+$', '', name ), 0 ) ), frame_from_dump( instructions ) )
+		callee = 0
+		for mnemonic, operands, target in instructions:
+			if mnemonic in ( 'icall', 'ijmp', 'eicall', 'eijmp' ):
+				errors.append( 'Indirect call in %s' % name )
+			elif not target or target == name or target in STARTUP_SYMBOLS:
+				continue
+			elif mnemonic in ( 'rcall', 'call' ):
+				callee = max( callee, RETURN_ADDRESS + depth( target ) )
+			elif mnemonic in ( 'rjmp', 'jmp' ) and target in functions and target not in ( '__prologue_saves__', '__epilogue_restores__' ):
+				callee = max( callee, depth( target ) ) # Tail Call
+		visiting.discard( name )
+		depths[name] = frame + callee
+		return depths[name]
+	for name in roots:
+		depth( name )
+	return depths, errors
+
+def main():
+	parser = argparse.ArgumentParser( description = 'Static analyzer of stack depth and SRAM usage for AVR' )
+	parser.add_argument( '--dump', required = True, help = 'Disassembly by avr-objdump -D' )
+	parser.add_argument( '--su', nargs = '*', default = [], help = 'Files by -fstack-usage' )
+	parser.add_argument( '--size', default = '0 0', help = 'Bytes of .data and .bss' )
+	parser.add_argument( '--sram', type = int, default = 64, help = 'Bytes of SRAM' )
+	parser.add_argument( '--name', default = 'program' )
+	arguments = parser.parse_args()
+
+	functions = parse_dump( arguments.dump )
+	vectors = sorted( ( name for name in functions if re.match( r'__vector_\d+$', name ) ), key = lambda name: int( name.split( '_' )[-1] ) )
+	if 'main' not in functions:
+		print( 'Error: main is not found in %s.' % arguments.dump )
+		return 1
+	depths, errors = analyze( functions, parse_su( arguments.su ), [ 'main' ] + vectors )
+	data, bss = ( int( value ) for value in arguments.size.split() )
+
+	depth_main = RETURN_ADDRESS + depths['main'] # Called from Startup Code
+	depth_vectors = {}
+	depth_nesting = 0
+	depth_single = 0
+	for name in vectors:
+		depth_vectors[name] = RETURN_ADDRESS + depths[name]
+		if any( mnemonic == 'sei' for mnemonic, operands, target in functions[name] ):
+			depth_nesting += depth_vectors[name]
+		else:
+			depth_single = max( depth_single, depth_vectors[name] )
+	depth_worst = depth_main + depth_nesting + depth_single
+
+	print( '%s: Stack main %d Bytes' % ( arguments.name, depth_main ) )
+	for name in vectors:
+		print( '%s: Stack %s %d Bytes' % ( arguments.name, name, depth_vectors[name] ) )
+	print( '%s: SRAM %d/%d Bytes (.data %d + .bss %d + Worst Stack %d)' % ( arguments.name, data + bss + depth_worst, arguments.sram, data, bss, depth_worst ) )
+	for error in sorted( set( errors ) ):
+		print( 'Error: %s' % error )
+	if errors:
+		return 1
+	if data + bss + depth_worst > arguments.sram:
+		print( 'Error: SRAM exceeds the budget.' )
+		return 1
+	return 0
+
+if __name__ == '__main__':
+	sys.exit( main() )
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Decoder and Validator of Framed Telemetry (include/telemetry.h) on Host
+ * Usage: telemetry_decode < /dev/ttyUSB0 (Set the baud rate with stty in advance)
+ *        telemetry_decode capture.bin
+ * Valid frames are printed to stdout, one line per frame. Errors and the summary are printed to stderr.
+ * If the CRC is unmatched, the decoder searches the next sync byte from the byte after the false sync.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "include/telemetry.h"
+
+/* Global Variables */
+
+uint8_t telemetry_decode_buffer[TELEMETRY_FRAME_MAX];
+unsigned int telemetry_decode_buffer_length;
+unsigned long telemetry_decode_count_valid;
+unsigned long telemetry_decode_count_crc_error;
+unsigned long telemetry_decode_count_length_error;
+unsigned long telemetry_decode_count_skipped_byte;
+unsigned long telemetry_decode_count_sequence_gap;
+int telemetry_decode_sequence_last = -1;
+
+static void telemetry_decode_print( uint8_t const* frame ) {
+	uint8_t type = frame[1];
+	uint8_t length = frame[2];
+	uint8_t const* payload = &frame[3];
+	if ( type == TELEMETRY_TYPE_ADC && length == 5 ) {
+		if ( telemetry_decode_sequence_last >= 0 && payload[0] != ((telemetry_decode_sequence_last + 1) & 0xFF) ) {
+			telemetry_decode_count_sequence_gap++;
+			fprintf( stderr, "sequence gap: %d -> %u\n", telemetry_decode_sequence_last, payload[0] );
+		}
+		telemetry_decode_sequence_last = payload[0];
+		printf( "adc seq=%u ch1=%u ch2=%u\n", payload[0], payload[1] | payload[2] << 8, payload[3] | payload[4] << 8 );
+	} else if ( type == TELEMETRY_TYPE_SEQUENCER && length == 4 ) {
+		printf( "sequencer program=%u step=%u byte=0x%02X osccal=0x%02X\n", payload[0], payload[1], payload[2], payload[3] );
+	} else {
+		printf( "type=0x%02X length=%u payload=", type, length );
+		for ( unsigned int i = 0; i < length; i++ ) printf( "%02X", payload[i] );
+		printf( "\n" );
+	}
+}
+
+// Drop the first byte in the buffer, and search the next sync byte.
+static void telemetry_decode_resync() {
+	unsigned int i;
+	for ( i = 1; i < telemetry_decode_buffer_length; i++ ) {
+		if ( telemetry_decode_buffer[i] == TELEMETRY_SYNC ) break;
+	}
+	telemetry_decode_count_skipped_byte += i;
+	memmove( telemetry_decode_buffer, &telemetry_decode_buffer[i], telemetry_decode_buffer_length - i );
+	telemetry_decode_buffer_length -= i;
+}
+
+static void telemetry_decode_byte( uint8_t byte ) {
+	if ( ! telemetry_decode_buffer_length && byte != TELEMETRY_SYNC ) {
+		telemetry_decode_count_skipped_byte++;
+		return;
+	}
+	telemetry_decode_buffer[telemetry_decode_buffer_length++] = byte;
+	while ( telemetry_decode_buffer_length >= 3 ) {
+		uint8_t length = telemetry_decode_buffer[2];
+		uint8_t crc;
+		if ( length > TELEMETRY_LENGTH_MAX ) {
+			telemetry_decode_count_length_error++;
+			telemetry_decode_resync();
+			continue;
+		}
+		if ( telemetry_decode_buffer_length < (unsigned int)length + 4 ) return; // Wait for Rest of Frame
+		crc = 0;
+		for ( unsigned int i = 1; i < (unsigned int)length + 3; i++ ) crc = telemetry_crc8( crc, telemetry_decode_buffer[i] );
+		if ( crc != telemetry_decode_buffer[length + 3] ) {
+			telemetry_decode_count_crc_error++;
+			telemetry_decode_resync();
+			continue;
+		}
+		telemetry_decode_count_valid++;
+		telemetry_decode_print( telemetry_decode_buffer );
+		telemetry_decode_buffer_length = 0;
+	}
+}
+
+int main( int argc, char** argv ) {
+	FILE* input = stdin;
+	int character;
+	if ( argc > 1 ) {
+		input = fopen( argv[1], "rb" );
+		if ( ! input ) {
+			perror( argv[1] );
+			return 2;
+		}
+	}
+	setvbuf( stdout, NULL, _IOLBF, 0 );
+	while ( (character = fgetc( input )) != EOF ) telemetry_decode_byte( (uint8_t)character );
+	fprintf( stderr, "valid=%lu crc_error=%lu length_error=%lu skipped_byte=%lu sequence_gap=%lu\n",
+		telemetry_decode_count_valid, telemetry_decode_count_crc_error, telemetry_decode_count_length_error,
+		telemetry_decode_count_skipped_byte, telemetry_decode_count_sequence_gap );
+	return (telemetry_decode_count_crc_error || telemetry_decode_count_length_error) ? 1 : 0;
+}
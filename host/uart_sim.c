@@ -0,0 +1,137 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Simulator of Software UART (85/include_85/software_uart.h) on Host
+ * The header is built with the mock of I/O registers (include_host/avr/io.h).
+ * Bits are fed to software_uart_handler_rx_tx() via PINB at the rate of the modelled clock (see sim_uart.h).
+ *
+ * Usage: uart_sim [seconds] [seed]
+ *  1. Bit error rate of Rx by baud error of the host and jitter of edges, OSCCAL is not adjusted.
+ *     Lost bytes count 8 bit errors.
+ *  2. Convergence of OSCCAL by the initial error of the clock.
+ *     Time to converge is the time after which the clock stays within the threshold of the handler (0.5%).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include "sim_uart.h"
+#include "include_85/software_uart.h"
+
+#define UART_SIM_OSCCAL_REFERENCE 0x60 // Typical Factory Calibration
+#define UART_SIM_THRESHOLD 0.005
+
+typedef struct {
+	uint32_t byte_sent;
+	uint32_t byte_received;
+	uint32_t byte_error;
+	uint32_t bit_error;
+	double time_converge; // Negative If Not Converged
+	double clock_final; // Error of Clock at the End
+} uart_sim_result;
+
+static double uart_sim_clock_error( sim_uart_clock const* clock, uint8_t osccal ) {
+	return 1.0 / (sim_uart_tick_period( clock, osccal ) * SIM_UART_TICK_RATE) - 1.0;
+}
+
+static void uart_sim_run( double baud_error, double jitter, double clock_error, uint8_t mode, double seconds, uint32_t seed, uart_sim_result* result ) {
+	sim_uart_clock clock = { clock_error, UART_SIM_OSCCAL_REFERENCE };
+	sim_uart_line line;
+	uint32_t random = seed;
+	uint8_t byte_previous = 0xFF;
+	uint8_t buffer_change = 0;
+	uint8_t expected;
+	double time = 0.0;
+	double time_next = 0.005;
+	double bit_time = 1.0 / (SOFTWARE_UART_BAUD_RATE * (1.0 + baud_error));
+	uint32_t count_second = 0;
+	sim_uart_line_init( &line, SOFTWARE_UART_BAUD_RATE * (1.0 + baud_error), jitter, seed );
+	software_uart_init();
+	OSCCAL = UART_SIM_OSCCAL_REFERENCE;
+	PINB = _BV(SOFTWARE_UART_PIN_RX);
+	PORTB = _BV(SOFTWARE_UART_PIN_TX);
+	result->byte_sent = 0;
+	result->byte_received = 0;
+	result->byte_error = 0;
+	result->bit_error = 0;
+	result->time_converge = -1.0;
+	while ( time < seconds ) {
+		if ( time >= time_next ) {
+			byte_previous = line.byte;
+			sim_uart_line_send( &line, time_next, sim_uart_random( &random ) & 0xFF );
+			result->byte_sent++;
+			time_next += line.byte_interval;
+		}
+		PINB = sim_uart_line_level( &line, time ) << SOFTWARE_UART_PIN_RX;
+		software_uart_handler_rx_tx( mode );
+		if ( (software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT) != buffer_change ) {
+			buffer_change = software_uart_rx_status & SOFTWARE_UART_STATUS_RX_BUFFER_CHANGE_BIT;
+			// Received in the Last Data Bit or Later of Current Byte, Otherwise Previous Byte
+			expected = (time >= line.edge[SIM_UART_BITS - 1] - bit_time) ? line.byte : byte_previous;
+			result->byte_received++;
+			if ( software_uart_rx_byte_buffer != expected ) {
+				result->byte_error++;
+				result->bit_error += __builtin_popcount( software_uart_rx_byte_buffer ^ expected );
+			}
+		}
+		time += sim_uart_tick_period( &clock, OSCCAL );
+		if ( time >= count_second + 1.0 ) {
+			count_second++;
+			if ( fabs( uart_sim_clock_error( &clock, OSCCAL ) ) > UART_SIM_THRESHOLD ) {
+				result->time_converge = -1.0;
+			} else if ( result->time_converge < 0.0 ) {
+				result->time_converge = count_second;
+			}
+		}
+	}
+	if ( result->byte_received < result->byte_sent ) { // Lost Bytes, Except a Byte in Progress
+		uint32_t lost = result->byte_sent - result->byte_received;
+		if ( time < line.edge[SIM_UART_BITS] ) lost--;
+		result->byte_error += lost;
+		result->bit_error += lost * 8;
+	}
+	result->clock_final = uart_sim_clock_error( &clock, OSCCAL );
+}
+
+int main( int argc, char** argv ) {
+	double seconds = (argc > 1) ? atof( argv[1] ) : 10.0;
+	uint32_t seed = (argc > 2) ? strtoul( argv[2], NULL, 0 ) : 1;
+	double const jitters[] = { 0.0, 0.05, 0.10, 0.20 };
+	double const clock_errors[] = { -0.04, -0.02, -0.01, 0.01, 0.02, 0.04 };
+	uart_sim_result result;
+	if ( seconds <= 0.0 || ! seed ) {
+		fprintf( stderr, "Usage: %s [seconds] [seed (not zero)]\n", argv[0] );
+		return 1;
+	}
+
+	printf( "Bit Error Rate of Rx (%.0f Seconds, %d Bytes per Second)\n", seconds, SOFTWARE_UART_FREQUENCY );
+	printf( "Baud Error" );
+	for ( size_t j = 0; j < sizeof( jitters ) / sizeof( jitters[0] ); j++ ) printf( "  Jitter %4.0f%%", jitters[j] * 100.0 );
+	printf( "\n" );
+	for ( int e = -60; e <= 60; e += 5 ) {
+		printf( "%+9.1f%%", e / 10.0 );
+		for ( size_t j = 0; j < sizeof( jitters ) / sizeof( jitters[0] ); j++ ) {
+			uart_sim_run( e / 1000.0, jitters[j], 0.0, 0, seconds, seed, &result );
+			printf( "  %12.2e", (double)result.bit_error / (result.byte_sent * 8.0) );
+		}
+		printf( "\n" );
+	}
+
+	printf( "\nConvergence of OSCCAL (%.0f Seconds, Initial OSCCAL 0x%02X, Jitter 5%%)\n", seconds * 6.0, UART_SIM_OSCCAL_REFERENCE );
+	printf( "Clock Error  Final OSCCAL  Final Error  Converged  Byte Errors\n" );
+	for ( size_t c = 0; c < sizeof( clock_errors ) / sizeof( clock_errors[0] ); c++ ) {
+		uart_sim_run( 0.0, 0.05, clock_errors[c], SOFTWARE_UART_HANDLER_RX_TX_MODE_ADJUST_OSC_BIT, seconds * 6.0, seed, &result );
+		printf( "%+10.1f%%          0x%02X  %+10.2f%%", clock_errors[c] * 100.0, OSCCAL, result.clock_final * 100.0 );
+		if ( result.time_converge < 0.0 ) {
+			printf( "          -" );
+		} else {
+			printf( "  %8.0fs", result.time_converge );
+		}
+		printf( "  %5u/%u\n", result.byte_error, result.byte_sent );
+	}
+	return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * ADSR Envelope Generator of Voices (ATtiny13 and ATtiny85)
+ * envelope_level[voice] is the gain in unsigned 0.8 format, multiply samples by it with include/fixed_math.h.
+ * Define ENVELOPE_SAMPLE_RATE (integer) and include include/fixed_math.h in advance.
+ * Call envelope_handler_sample() in the ISR of samples, it sets envelope_is_update at the control rate (approx. 1kHz).
+ * Call envelope_update() in the main loop if envelope_is_update is set, so the ISR of samples is not extended by updates.
+ * Call envelope_note_on() and envelope_note_off() in the main loop as well.
+ *
+ * A program of an envelope is 4 bytes in program space, indexed by ENVELOPE_ATTACK, ENVELOPE_DECAY, ENVELOPE_SUSTAIN, and ENVELOPE_RELEASE.
+ *  Attack, decay, and release are indexes of envelope_rate_array (0-15), and sustain is the level (0x00-0xFF).
+ *  Each update moves the level toward the target by the rate (one pole), so the time constant is approx. 256 / rate milliseconds.
+ *  The level moves one step at least, e.g., the rate 0x01 makes the linear slope of 255 milliseconds from 0xFF to 0x00.
+ * Attack starts from the current level to avoid clicks, and retriggering during release is smooth.
+ */
+
+#ifndef ENVELOPE_SAMPLE_RATE
+#error "Define ENVELOPE_SAMPLE_RATE before include/envelope.h."
+#endif
+#ifndef ENVELOPE_VOICE_NUMBER
+#define ENVELOPE_VOICE_NUMBER 1
+#endif
+#define ENVELOPE_CONTROL_RATE 1000
+#define ENVELOPE_CONTROL_DIVISOR ((ENVELOPE_SAMPLE_RATE + ENVELOPE_CONTROL_RATE / 2) / ENVELOPE_CONTROL_RATE) // Samples per Update
+#define ENVELOPE_ATTACK 0
+#define ENVELOPE_DECAY 1
+#define ENVELOPE_SUSTAIN 2
+#define ENVELOPE_RELEASE 3
+#define ENVELOPE_PARAMETER_NUMBER 4
+#define ENVELOPE_STATE_IDLE 0
+#define ENVELOPE_STATE_ATTACK 1
+#define ENVELOPE_STATE_DECAY 2
+#define ENVELOPE_STATE_SUSTAIN 3
+#define ENVELOPE_STATE_RELEASE 4
+
+_Static_assert( ENVELOPE_CONTROL_DIVISOR >= 1 && ENVELOPE_CONTROL_DIVISOR <= 0xFF, "ENVELOPE_CONTROL_DIVISOR must fit in 8 bits." );
+
+/* Global Variables without Initialization to Define at .bss Section and Squash .data Section */
+
+volatile uint8_t envelope_level[ENVELOPE_VOICE_NUMBER];
+volatile uint8_t envelope_is_update;
+uint8_t envelope_control_count;
+uint8_t envelope_state[ENVELOPE_VOICE_NUMBER];
+uint8_t const* envelope_program[ENVELOPE_VOICE_NUMBER]; // Address in Program Space
+
+// Rate per Update (Unsigned 0.8), Time Constant Is Approx. 256 / Rate Milliseconds
+uint8_t const envelope_rate_array[16] PROGMEM = { // Array in Program Space
+	0xFF, // 1ms
+	0xB4, // 1.4ms
+	0x80, // 2ms
+	0x5A, // 2.8ms
+	0x40, // 4ms
+	0x2D, // 5.7ms
+	0x20, // 8ms
+	0x17, // 11ms
+	0x10, // 16ms
+	0x0B, // 23ms
+	0x08, // 32ms
+	0x06, // 43ms
+	0x04, // 64ms
+	0x03, // 85ms
+	0x02, // 128ms
+	0x01 // 255ms (Linear)
+};
+
+static inline void envelope_init() {
+	for ( uint8_t voice = 0; voice < ENVELOPE_VOICE_NUMBER; voice++ ) {
+		envelope_level[voice] = 0;
+		envelope_state[voice] = ENVELOPE_STATE_IDLE;
+		envelope_program[voice] = 0;
+	}
+	envelope_is_update = 0;
+	envelope_control_count = ENVELOPE_CONTROL_DIVISOR;
+}
+
+// program: Address of ENVELOPE_PARAMETER_NUMBER Bytes in Program Space
+static inline void envelope_note_on( uint8_t voice, uint8_t const* program ) {
+	envelope_program[voice] = program;
+	envelope_state[voice] = ENVELOPE_STATE_ATTACK;
+}
+
+static inline void envelope_note_off( uint8_t voice ) {
+	if ( envelope_state[voice] != ENVELOPE_STATE_IDLE ) envelope_state[voice] = ENVELOPE_STATE_RELEASE;
+}
+
+// Call in the ISR of Samples
+static inline void envelope_handler_sample() {
+	if ( --envelope_control_count ) return;
+	envelope_control_count = ENVELOPE_CONTROL_DIVISOR;
+	envelope_is_update = 1;
+}
+
+// Move Level toward Target by Rate, One Step at Least
+static inline uint8_t envelope_approach( uint8_t level, uint8_t target, uint8_t rate_index ) {
+	uint8_t level_next = fixed_math_lerp_u8( level, target, pgm_read_byte(&(envelope_rate_array[rate_index & 0xF])) );
+	if ( level_next == level ) {
+		if ( level < target ) {
+			level_next++;
+		} else if ( level > target ) {
+			level_next--;
+		}
+	}
+	return level_next;
+}
+
+// Call in the Main Loop If envelope_is_update Is Set
+static inline void envelope_update() {
+	uint8_t level;
+	uint8_t sustain;
+	uint8_t const* program;
+	envelope_is_update = 0;
+	for ( uint8_t voice = 0; voice < ENVELOPE_VOICE_NUMBER; voice++ ) {
+		level = envelope_level[voice];
+		program = envelope_program[voice];
+		if ( envelope_state[voice] == ENVELOPE_STATE_ATTACK ) {
+			level = envelope_approach( level, 0xFF, pgm_read_byte(&(program[ENVELOPE_ATTACK])) );
+			if ( level == 0xFF ) envelope_state[voice] = ENVELOPE_STATE_DECAY;
+		} else if ( envelope_state[voice] == ENVELOPE_STATE_DECAY ) {
+			sustain = pgm_read_byte(&(program[ENVELOPE_SUSTAIN]));
+			level = envelope_approach( level, sustain, pgm_read_byte(&(program[ENVELOPE_DECAY])) );
+			if ( level == sustain ) envelope_state[voice] = ENVELOPE_STATE_SUSTAIN;
+		} else if ( envelope_state[voice] == ENVELOPE_STATE_RELEASE ) {
+			level = envelope_approach( level, 0x00, pgm_read_byte(&(program[ENVELOPE_RELEASE])) );
+			if ( ! level ) envelope_state[voice] = ENVELOPE_STATE_IDLE;
+		}
+		envelope_level[voice] = level;
+	}
+}
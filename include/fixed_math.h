@@ -0,0 +1,176 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Fixed-point Math of 8-bit Fractions for Audio Rate (ATtiny13 and ATtiny85)
+ * Fractions are unsigned 0.8 (0x00 = 0.0, 0xFF = 0.996) and signed 1.7 (0x80 = -1.0, 0x7F = 0.992) formats.
+ * A gain of 0xFF doesn't make the same value, e.g., fixed_math_mul_u8( 0xFF, 0xFF ) is 0xFE. Bypass the multiply for unity gain if needed.
+ * Results are truncated toward negative infinity, i.e., the high byte of the product.
+ * ATtiny13 (avr2) and ATtiny85 (avr25) have no MUL instruction, so the multiply is shift-add of 8 turns in constant clocks:
+ *   FIXED_MATH_UNROLL 0: 58 Clocks, 9 Words
+ *   FIXED_MATH_UNROLL 1: 34 Clocks, 34 Words for Each Call (Inlined)
+ * MUL and MULSU (4 clocks) are used only on AVRs with the hardware multiplier (__AVR_HAVE_MUL__, e.g., avr4 and avr5), not on ATtiny.
+ * Functions are also built with C on hosts to verify them.
+ */
+
+#ifndef FIXED_MATH_UNROLL
+#define FIXED_MATH_UNROLL 0 // 0 = Loop of Shift-add, 1 = Unrolled Shift-add (Faster but Larger)
+#endif
+
+// Unsigned 8x8 to 16-bit Product
+static inline uint16_t fixed_math_mul_u8_u16( uint8_t a, uint8_t b ) {
+#if defined(__AVR_HAVE_MUL__)
+	uint16_t product;
+	asm (
+		"mul %[a], %[b]" "\n\t"
+		"movw %[product], r0" "\n\t"
+		"clr __zero_reg__" "\n\t"
+		/* Outputs */
+		:[product]"=r"(product)
+		/* Inputs */
+		:[a]"r"(a),
+		 [b]"r"(b)
+		/* Clobber List */
+		:"r0"
+	);
+	return product;
+#elif defined(__AVR__)
+	uint8_t high;
+#if FIXED_MATH_UNROLL
+	asm (
+		"clr %[high]" "\n\t"
+		"lsr %[low]" "\n\t" /* Bit[0] of Multiplier to Carry */
+		".rept 8" "\n\t"
+			"brcc 1f" "\n\t" /* Two Clocks on Both Branches */
+			"add %[high], %[a]" "\n\t"
+			"1:" "\n\t"
+			"ror %[high]" "\n\t" /* Carry of Addition to Bit[7] */
+			"ror %[low]" "\n\t" /* Bit[0] of Product to Bit[7], and Next Bit of Multiplier to Carry */
+		".endr" "\n\t"
+		/* Outputs */
+		:[high]"=&r"(high),
+		 [low]"+&r"(b)
+		/* Inputs */
+		:[a]"r"(a)
+		/* Clobber List */
+		:
+	);
+#else
+	uint8_t count;
+	asm (
+		"clr %[high]" "\n\t"
+		"ldi %[count], 8" "\n\t"
+		"lsr %[low]" "\n\t" /* Bit[0] of Multiplier to Carry */
+		"1:" "\n\t"
+			"brcc 2f" "\n\t" /* Two Clocks on Both Branches */
+			"add %[high], %[a]" "\n\t"
+			"2:" "\n\t"
+			"ror %[high]" "\n\t" /* Carry of Addition to Bit[7] */
+			"ror %[low]" "\n\t" /* Bit[0] of Product to Bit[7], and Next Bit of Multiplier to Carry */
+			"dec %[count]" "\n\t" /* DEC Doesn't Change Carry */
+			"brne 1b" "\n\t"
+		/* Outputs */
+		:[high]"=&r"(high),
+		 [low]"+&r"(b),
+		 [count]"=&d"(count)
+		/* Inputs */
+		:[a]"r"(a)
+		/* Clobber List */
+		:
+	);
+#endif
+	return ((uint16_t)high << 8)|b;
+#else
+	return (uint16_t)a * b;
+#endif
+}
+
+// Unsigned 0.8 x Unsigned 0.8 to Unsigned 0.8
+static inline uint8_t fixed_math_mul_u8( uint8_t a, uint8_t b ) {
+	return fixed_math_mul_u8_u16( a, b ) >> 8;
+}
+
+/**
+ * Signed 1.7 x Unsigned 0.8 to Signed 1.7, e.g., a sample by a gain
+ * Without MULSU, a is biased to unsigned by adding 0x80, and 0x80 * b is subtracted from the unsigned product.
+ * It keeps constant clocks with the shift-add, i.e., the multiply and approx. 8 clocks.
+ */
+static inline int8_t fixed_math_mul_s8( int8_t a, uint8_t b ) {
+#if defined(__AVR_HAVE_MUL__)
+	int8_t high;
+	asm (
+		"mulsu %[a], %[b]" "\n\t"
+		"mov %[high], r1" "\n\t"
+		"clr __zero_reg__" "\n\t"
+		/* Outputs */
+		:[high]"=r"(high)
+		/* Inputs */
+		:[a]"a"(a), // MULSU Needs R16-R23
+		 [b]"a"(b)
+		/* Clobber List */
+		:"r0"
+	);
+	return high;
+#else
+	return (int8_t)((uint16_t)(fixed_math_mul_u8_u16( (uint8_t)a ^ 0x80, b ) - ((uint16_t)b << 7)) >> 8);
+#endif
+}
+
+// Unsigned Saturating Add, 3 Clocks on AVR
+static inline uint8_t fixed_math_add_sat_u8( uint8_t a, uint8_t b ) {
+#if defined(__AVR__)
+	uint8_t temp;
+	asm (
+		"add %[a], %[b]" "\n\t"
+		"sbc %[temp], %[temp]" "\n\t" /* 0xFF on Carry */
+		"or %[a], %[temp]" "\n\t"
+		/* Outputs */
+		:[a]"+r"(a),
+		 [temp]"=&r"(temp)
+		/* Inputs */
+		:[b]"r"(b)
+		/* Clobber List */
+		:
+	);
+	return a;
+#else
+	uint16_t sum = (uint16_t)a + b;
+	return sum > 0xFF ? 0xFF : sum;
+#endif
+}
+
+// Signed Saturating Add, 3 Clocks on AVR without Overflow, 5 Clocks with Overflow
+static inline int8_t fixed_math_add_sat_s8( int8_t a, int8_t b ) {
+#if defined(__AVR__)
+	asm (
+		"add %[a], %[b]" "\n\t"
+		"brvc 1f" "\n\t"
+		"ldi %[a], 0x7F" "\n\t"
+		"sbrc %[b], 7" "\n\t" /* Overflow to Negative Only If b Is Negative */
+		"ldi %[a], 0x80" "\n\t"
+		"1:" "\n\t"
+		/* Outputs */
+		:[a]"+&d"(a)
+		/* Inputs */
+		:[b]"r"(b)
+		/* Clobber List */
+		:
+	);
+	return a;
+#else
+	int16_t sum = (int16_t)a + b;
+	return sum > 127 ? 127 : (sum < -128 ? -128 : sum);
+#endif
+}
+
+/**
+ * Linear Interpolation from a (t = 0x00) toward b (t = 0xFF), One Multiply
+ * The result is rounded toward a, and it never exceeds the range between a and b.
+ */
+static inline uint8_t fixed_math_lerp_u8( uint8_t a, uint8_t b, uint8_t t ) {
+	if ( b >= a ) return a + fixed_math_mul_u8( b - a, t );
+	return a - fixed_math_mul_u8( a - b, t );
+}
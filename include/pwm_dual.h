@@ -0,0 +1,21 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Dual PWM Output of a 16-bit Sample with Timer/Counter0 (ATtiny13 and ATtiny85)
+ * OC0A (PB0) outputs the high byte, and OC0B (PB1) outputs the low byte in the same PWM mode with TOP 0xFF.
+ * Sum them with resistors of 1:256 ratio, e.g., 1k ohms from OC0A and 256k ohms (255k ohms of E96) from OC0B, then filter as a single PWM output.
+ *   Vout = (256 * V(OC0A) + V(OC0B)) / 257, so OC0B adds 1/256 steps between steps of OC0A.
+ * The effective resolution depends on the matching of resistors and the output resistance of pins (approx. 25 ohms),
+ * e.g., resistors of 1% makes approx. 12-14 bits. Use a larger resistor from OC0A to reduce the error of the output resistance.
+ * Set COM0B1 with COM0A1 in TCCR0A and DDB1 with DDB0 in DDRB. OCR0B can't be used for other purposes, e.g., the interrupt of software UART Tx.
+ * The same voltage bias as 8-bit output is the high byte in the upper 8 bits, e.g., 0x8000 for 0x80.
+ */
+
+static inline void pwm_dual_set( uint16_t value ) {
+	OCR0B = value & 0xFF;
+	OCR0A = value >> 8;
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright 2021 Kenta Ishii
+ * License: 3-Clause BSD License
+ * SPDX Short Identifier: BSD-3-Clause
+ */
+
+/**
+ * Framed Telemetry
+ * Frame: Sync (0xA5), Type, Length of Payload, Payload (0-16 Bytes), CRC-8
+ * CRC-8 is calculated from the type to the end of the payload,
+ * Polynomial 0x07 (x^8 + x^2 + x + 1), Initial Value 0x00, No Reflection, No Final XOR.
+ * The CRC is calculated bit by bit, because a table (256 bytes) is too large for ATtiny13.
+ * The sync byte may appear in the payload. The receiver searches the next sync byte if the CRC is unmatched.
+ * See host/telemetry_decode.c to decode frames.
+ *
+ * TELEMETRY_TYPE_ADC: Sequence Number (Bit[7:0]), Channel 1 (Low, High), Channel 2 (Low, High), 10-bit Values in Little Endian
+ * TELEMETRY_TYPE_SEQUENCER: Program Index, Step (Bit[7:0]), Program Byte, OSCCAL
+ */
+
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_CRC8_POLYNOMIAL 0x07
+#define TELEMETRY_LENGTH_MAX 16 // Maximum Length of Payload
+#define TELEMETRY_FRAME_MAX (TELEMETRY_LENGTH_MAX + 4)
+#define TELEMETRY_TYPE_ADC 0x01
+#define TELEMETRY_TYPE_SEQUENCER 0x02
+
+static inline uint8_t telemetry_crc8( uint8_t crc, uint8_t byte ) {
+	crc ^= byte;
+	for ( uint8_t i = 0; i < 8; i++ ) {
+		if ( crc & 0x80 ) {
+			crc = (crc << 1) ^ TELEMETRY_CRC8_POLYNOMIAL;
+		} else {
+			crc <<= 1;
+		}
+	}
+	return crc;
+}
+
+// Make a frame from the payload, and return the length of the frame. The frame needs length + 4 bytes.
+static inline uint8_t telemetry_make( uint8_t* frame, uint8_t type, uint8_t const* payload, uint8_t length ) {
+	uint8_t crc;
+	frame[0] = TELEMETRY_SYNC;
+	frame[1] = type;
+	frame[2] = length;
+	crc = telemetry_crc8( telemetry_crc8( 0, type ), length );
+	for ( uint8_t i = 0; i < length; i++ ) {
+		frame[3 + i] = payload[i];
+		crc = telemetry_crc8( crc, payload[i] );
+	}
+	frame[3 + length] = crc;
+	return length + 4;
+}